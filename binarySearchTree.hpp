@@ -3,43 +3,116 @@
 
 #include "iterators.hpp"
 #include "pair.hpp"
+#include "treeBalance.hpp"
 #include <memory>
+#include <new>
+#include <utility>
+#include <stdint.h>
 
 namespace ft
 {
-	template < class T >
-	class node
+	/*
+	** Node augmentation policies. The node derives from
+	** Augment::node_base<Node>, whose hooks the tree calls on every change:
+	**   pull()                : recompute the node data from its children
+	**   pull_path(header)     : pull() from this node up to the root
+	**   copy_stats(src)       : take over the data of a cloned node
+	** counted tells whether count_of(node) gives the size of a subtree.
+	** ft::no_order_statistics is an empty base: nothing is stored or walked.
+	*/
+	struct no_order_statistics
+	{
+		template < class Node >
+		struct node_base
+		{
+			static const bool counted = false;
+
+			static size_t count_of(const Node*)
+			{ return (0); }
+
+			void pull() {}
+			void pull_path(Node*) {}
+			void copy_stats(const Node&) {}
+		};
+	};
+
+	/*
+	** Every node counts the nodes of its subtree, which gives the tree
+	** rank/select in O(log n) at the price of a walk to the root on each
+	** insert and erase.
+	*/
+	struct order_statistics
+	{
+		template < class Node >
+		struct node_base
+		{
+			static const bool counted = true;
+
+			size_t count;
+
+			node_base() : count(1) {}
+
+			static size_t count_of(const Node* node)
+			{ return (node == nullptr ? 0 : node->count); }
+
+			void pull()
+			{
+				Node* self = static_cast<Node*>(this);
+				count = 1 + count_of(self->left) + count_of(self->right);
+			}
+
+			void pull_path(Node* header)
+			{
+				for (Node* node = static_cast<Node*>(this); node != header; node = node->parent())
+					node->pull();
+			}
+
+			void copy_stats(const Node& src)
+			{ count = src.count; }
+		};
+	};
+
+	/*
+	** No virtual member, so no vptr: a node is its value and three links,
+	** plus what Augment stores (nothing by default).
+	** The balancing metadata (a color or a balance factor in [-1, 1]) is
+	** stored as meta + 1 in the two low bits of the parent link, which are
+	** always zero since a node is at least pointer aligned.
+	*/
+	template < class T, class Augment = ft::no_order_statistics >
+	class node : public Augment::template node_base< node<T, Augment> >
 	{
 		public:
 
 			typedef T   value_type;
 
 			value_type	value;
-			node* 		parent;
 			node* 		left;
 			node* 		right;
 
-			node(): value(), left(nullptr), right(nullptr), parent(nullptr) {}
-
 			node (node* parent = nullptr, node* left = nullptr, node* right = nullptr) :
-				value(),parent(parent),left(left),right(right) {}
+				value(),left(left),right(right),_parent_meta(_pack(parent, 0)) {}
 
 			node(const value_type& val, node* parent = nullptr, node* left = nullptr, node* right = nullptr) :
-				value(val),parent(parent),left(left),right(right) {}
+				value(val),left(left),right(right),_parent_meta(_pack(parent, 0)) {}
 
-			node (const node& nd) : value(nd.value), parent(nd.parent), left(nd.left), right(nd.right) {}
+			// Value built in place from args
+			template < class... Args >
+			node(ft::in_place_t, Args&&... args) :
+				value(std::forward<Args>(args)...),left(nullptr),right(nullptr),_parent_meta(_pack(nullptr, 0)) {}
 
-			virtual ~node() {}
+			node (const node& nd) : Augment::template node_base<node>(nd), value(nd.value), left(nd.left), right(nd.right), _parent_meta(nd._parent_meta) {}
 
 			node &operator=(const node& nd)
             {
                 if (nd == *this)
                     return (*this);
                 
+                Augment::template node_base<node>::operator=(nd);
                 this->value = nd.value;
-                this->parent = nd.parent;
                 this->left = nd.left;
                 this->right = nd.right;
+                this->_parent_meta = nd._parent_meta;
                 
                 return (*this);
             }
@@ -51,10 +124,64 @@ namespace ft
                 return (false);
             }
 
+			node* parent() const
+			{ return (reinterpret_cast<node*>(_parent_meta & ~_meta_mask)); }
+
+			void set_parent(node* parent)
+			{ _parent_meta = _pack(parent, meta()); }
+
+			// owned by the balancing policy
+			signed char meta() const
+			{ return (static_cast<signed char>(_parent_meta & _meta_mask) - 1); }
+
+			void set_meta(int meta)
+			{ _parent_meta = (_parent_meta & ~_meta_mask) | static_cast<uintptr_t>(meta + 1); }
+
+		private:
+
+			static const uintptr_t _meta_mask = 3;
+
+			static uintptr_t _pack(node* parent, int meta)
+			{ return (reinterpret_cast<uintptr_t>(parent) | static_cast<uintptr_t>(meta + 1)); }
+
+			uintptr_t	_parent_meta;
 	};
 
+	/*
+	** Key extractors: how the tree gets the key out of a stored value
+	*/
+	template < class Pair >
+	struct select_first
+	{
+		typedef typename Pair::first_type key_type;
+
+		static const key_type& key(const Pair& value)
+		{ return (value.first); }
+	};
+
+	template < class T >
+	struct identity
+	{
+		typedef T key_type;
+
+		static const key_type& key(const T& value)
+		{ return (value); }
+	};
+
+	/*
+	** Key policies: with ft::equal_keys a value equal to others is linked
+	** after them (upper bound position), still in a single descent
+	*/
+	struct unique_keys
+	{ static const bool unique = true; };
+
+	struct equal_keys
+	{ static const bool unique = false; };
+
 	template <class T, class Compare = std::less<T>, class Node = ft::node<T>,
-			class Type_Alloc = std::allocator<T>, class Node_Alloc = std::allocator<Node> >
+			class Type_Alloc = std::allocator<T>, class Node_Alloc = std::allocator<Node>,
+			class Balance = ft::red_black_balance, class KeyOf = ft::select_first<T>,
+			class Keys = ft::unique_keys >
 	class BST
 	{
 		public :
@@ -65,90 +192,647 @@ namespace ft
 			
 			typedef T   value_type;
 
+			typedef typename KeyOf::key_type key_type;
+
+			typedef Compare key_compare;
+
 			typedef Node node_type;
 
 			typedef Node *  node_pointer;
 			
 			typedef Node_Alloc  node_alloc;
 
-			typedef ft::BST_iterator<Node, Compare> iterator;
+			typedef Balance balance_policy;
+
+			typedef Keys key_policy;
+
+			typedef ft::BST_iterator<Node> iterator;
 
-			typedef ft::BST_const_iterator<Node, Compare> const_iterator;
+			typedef ft::BST_const_iterator<Node> const_iterator;
 			
 			typedef size_t size_type;
 
-			BST (const node_alloc& node_alloc_init = node_alloc())
+			BST (const key_compare& comp = key_compare(), const node_alloc& node_alloc_init = node_alloc())
 			:
-				_node_alloc(node_alloc_init)
+				_node_alloc(node_alloc_init),
+				_comp(comp),
+				_size(0)
 			{
 				_last_node = _node_alloc.allocate(1);
-				_node_alloc.construct(_last_node, Node(_last_node, _last_node, _last_node));
+				_node_alloc.construct(_last_node, Node(nullptr, _last_node, _last_node));
 			}
 
 			~BST ()
 			{
+				clear();
 				_node_alloc.destroy(_last_node);
 				_node_alloc.deallocate(_last_node, 1);	
 			}
 
-			ft::pair<iterator, bool> insertPair(value_type to_insert)
+			// With unique keys an equal key stops the descent; with equal keys
+			// the value goes right of its equals
+			ft::pair<iterator, bool> insertPair(const value_type& to_insert)
 			{
-				Node * new_node = _node_alloc.allocate(1);
-				Node * prev_node = _last_node;
-				Node * start_node = _last_node->parent;
+				node_pointer parent;
+				bool side;
+				node_pointer found = findSlot(KeyOf::key(to_insert), parent, side);
+
+				if (found != nullptr)
+					return (ft::make_pair(iterator(found, _last_node), false));
+				return (ft::make_pair(_insertAt(parent, side, to_insert), true));
+			}
 
-				// side == false = left; side == true = right;
-				bool side = true;
+			/*
+			** Single descent upserts: findSlot() tells where a key is or would
+			** go, emplaceAt() then links a new value there without searching again
+			*/
 
-				while (start_node != _last_node)
+			// Returns the node holding key with unique keys, else nullptr and the
+			// child slot (side == true = right) of parent where key belongs;
+			// equal keys go right of their equals
+			node_pointer findSlot(const key_type& key, node_pointer& parent, bool& side) const
+			{
+				node_pointer node = _last_node->parent();
+
+				parent = _last_node;
+				side = true;
+				while (node != nullptr)
 				{
-					int curkey = start_node->value.first;
-					if (curkey == to_insert.first)
-						return (ft::make_pair(iterator(start_node, _last_node), false));
-					prev_node = start_node;
-					if (to_insert.first > curkey)
+					parent = node;
+					if (_comp(key, _key(node)))
 					{
-						side = true;
-						start_node = start_node->right;
+						side = false;
+						node = node->left;
 					}
+					else if (Keys::unique && !_comp(_key(node), key))
+						return (node);
 					else
 					{
-						side = false;
-						start_node = start_node->left;
+						side = true;
+						node = node->right;
 					}
 				}
-				_node_alloc.construct(new_node, Node(to_insert, prev_node, _last_node, _last_node));
-				
-				if (prev_node == _last_node)
-					_last_node->parent = new_node;
-				else if (side == true)
-					prev_node->right = new_node;
+				return (nullptr);
+			}
+
+			// Links a value built in place from args at a slot given by findSlot()
+			template < class... Args >
+			iterator emplaceAt(node_pointer parent, bool side, Args&&... args)
+			{
+				node_pointer new_node = _node_alloc.allocate(1);
+				new (static_cast<void*>(new_node)) Node(ft::in_place_t(), std::forward<Args>(args)...);
+				return (_linkAt(parent, side, new_node));
+			}
+
+			/*
+			** Node splicing: a node taken out by extractNode() keeps its value
+			** and can be linked back by insertNode(), here or into any tree
+			** whose Node_Alloc compares equal, without allocating or copying
+			*/
+
+			// Unlinks node from the tree, leaving it a lone leaf the caller owns
+			node_pointer extractNode(node_pointer node)
+			{
+				_unlinkNode(node);
+				_makeLone(node);
+				return (node);
+			}
+
+			// Links an extracted node where insertPair() would put its value.
+			// With unique keys and its key already there, the node stays with
+			// the caller and the second member is false.
+			ft::pair<iterator, bool> insertNode(node_pointer node)
+			{
+				node_pointer parent;
+				bool side;
+				node_pointer found = findSlot(_key(node), parent, side);
+
+				if (found != nullptr)
+					return (ft::make_pair(iterator(found, _last_node), false));
+				return (ft::make_pair(_linkAt(parent, side, node), true));
+			}
+
+			// Moves the nodes of x whose key is not here yet (all of them with
+			// equal keys). When both pools compare equal the nodes themselves
+			// are relinked, else each value is copied and its node freed.
+			void merge(self& x)
+			{
+				if (&x == this)
+					return ;
+
+				bool splice = (_node_alloc == x._node_alloc);
+				node_pointer node = x._last_node->left;
+
+				while (node != x._last_node)
+				{
+					node_pointer next = x._successor(node);
+					node_pointer parent;
+					bool side;
+
+					if (findSlot(_key(node), parent, side) == nullptr)
+					{
+						if (splice)
+							_linkAt(parent, side, x.extractNode(node));
+						else
+						{
+							_insertAt(parent, side, node->value);
+							x._eraseNode(node);
+						}
+					}
+					node = next;
+				}
+			}
+
+			// Insertion next to hint: when to_insert sorts right before or right
+			// after it, the node is linked there without descending from the root
+			ft::pair<iterator, bool> insertHint(node_pointer hint, const value_type& to_insert)
+			{
+				if (!Keys::unique)
+					return (ft::make_pair(_insertBefore(hint, to_insert), true));
+				if (hint == _last_node)
+				{
+					if (_size > 0 && _comp(_key(_last_node->right), KeyOf::key(to_insert)))
+						return (ft::make_pair(_insertAt(_last_node->right, true, to_insert), true));
+					return (insertPair(to_insert));
+				}
+				if (_comp(KeyOf::key(to_insert), _key(hint)))
+				{
+					if (hint == _last_node->left)
+						return (ft::make_pair(_insertAt(hint, false, to_insert), true));
+					node_pointer before = _predecessor(hint);
+					if (!_comp(_key(before), KeyOf::key(to_insert)))
+						return (insertPair(to_insert));
+					if (before->right == nullptr)
+						return (ft::make_pair(_insertAt(before, true, to_insert), true));
+					return (ft::make_pair(_insertAt(hint, false, to_insert), true));
+				}
+				if (_comp(_key(hint), KeyOf::key(to_insert)))
+				{
+					if (hint == _last_node->right)
+						return (ft::make_pair(_insertAt(hint, true, to_insert), true));
+					node_pointer after = _successor(hint);
+					if (!_comp(KeyOf::key(to_insert), _key(after)))
+						return (insertPair(to_insert));
+					if (hint->right == nullptr)
+						return (ft::make_pair(_insertAt(hint, true, to_insert), true));
+					return (ft::make_pair(_insertAt(after, false, to_insert), true));
+				}
+				return (ft::make_pair(iterator(hint, _last_node), false));
+			}
+
+			// On an empty tree the sorted prefix of the range (strictly sorted
+			// with unique keys) is linked into a perfectly balanced tree in O(n);
+			// whatever follows, or any range into a non empty tree, is inserted
+			// next to the previous element
+			template < class InputIterator >
+			void insertRange(InputIterator first, InputIterator last)
+			{
+				if (_size == 0 && first != last)
+				{
+					node_pointer head = nullptr;
+					node_pointer tail = nullptr;
+					size_type n = 0;
+
+					while (first != last)
+					{
+						// a key equal to the tail is skipped (unique keys) or kept
+						if (tail != nullptr && !_comp(_key(tail), KeyOf::key(*first)))
+						{
+							if (_comp(KeyOf::key(*first), _key(tail)))
+								break ;
+							if (Keys::unique)
+							{
+								++first;
+								continue ;
+							}
+						}
+						node_pointer new_node = _node_alloc.allocate(1);
+						_node_alloc.construct(new_node, Node(*first, nullptr, nullptr, nullptr));
+						if (tail == nullptr)
+							head = new_node;
+						else
+							tail->right = new_node;
+						tail = new_node;
+						++n;
+						++first;
+					}
+					_linkChain(head, tail, n);
+				}
+
+				node_pointer hint = _last_node;
+				for (; first != last; ++first)
+				{
+					// equal keys go after those already there, as one by one inserts do
+					if (!Keys::unique && hint != _last_node && !_comp(KeyOf::key(*first), _key(hint)))
+						hint = _last_node;
+					hint = _successor(insertHint(hint, *first).first.base());
+				}
+			}
+
+			/*
+			** Sorted building: on an empty tree, values appended in increasing
+			** key order (non decreasing with equal keys) are only chained, then
+			** buildAppended() links them into a balanced tree in O(n). The tree
+			** must be left alone in between.
+			*/
+
+			class append_iterator
+			{
+				public:
+
+					typedef ft::output_iterator_tag iterator_category;
+					typedef void                    value_type;
+					typedef void                    difference_type;
+					typedef void                    pointer;
+					typedef void                    reference;
+
+					explicit append_iterator(self* tree) : _tree(tree) {}
+
+					append_iterator& operator=(const T& value)
+					{
+						_tree->appendSorted(value);
+						return (*this);
+					}
+
+					append_iterator& operator*() { return (*this); }
+					append_iterator& operator++() { return (*this); }
+					append_iterator operator++(int) { return (*this); }
+
+				private:
+
+					self*   _tree;
+			};
+
+			append_iterator appender()
+			{ return (append_iterator(this)); }
+
+			void appendSorted(const value_type& value)
+			{
+				node_pointer new_node = _node_alloc.allocate(1);
+				_node_alloc.construct(new_node, Node(value, nullptr, nullptr, nullptr));
+
+				if (_size == 0)
+					_last_node->left = new_node;
 				else
-					prev_node->left = new_node;
-				
-				_last_node->left = _BST_get_lower_node(_last_node->parent);
-				_last_node->right = _BST_get_higher_node(_last_node->parent);
-				_last_node->value.first += 1;
-				return (ft::make_pair(iterator(new_node, _last_node), true));
+					_last_node->right->right = new_node;
+				_last_node->right = new_node;
+				_size += 1;
+			}
+
+			void buildAppended()
+			{
+				if (_size != 0 && _last_node->parent() == nullptr)
+					_linkChain(_last_node->left, _last_node->right, _size);
 			}
 
-			void removeByKey(value_type to_remove)
-			{ _removeByKey(_last_node->parent, to_remove); }
+			/*
+			** Tree surgery through Balance::join(), in O(log n): both trees must
+			** share their pool. Without order statistics the sizes are not
+			** known, so split() also counts the smaller part, in
+			** O(min(k, n - k)) for k keys less than key.
+			*/
 
-			node_pointer searchByKey(value_type to_remove)
+			// Moves the values whose key is not less than key into upper, empty
+			void split(const key_type& key, self& upper)
 			{
-				node_pointer node = _last_node->parent;
+				node_pointer root = _last_node->parent();
+				node_pointer low;
+				node_pointer high;
+				int low_height;
+				int high_height;
 
-				while (node != _last_node)
+				if (root == nullptr)
+					return ;
+				node_pointer max = _last_node->right;
+				size_type total = _size;
+
+				_split(root, Balance::join_height(root), key, low, low_height,
+					high, high_height, upper._last_node);
+				Balance::set_root(low, _last_node);
+				Balance::set_root(high, upper._last_node);
+				_last_node->right = _BST_get_higher_node(low);
+				if (low == nullptr)
+					_last_node->left = _last_node;
+				upper._last_node->left = upper._BST_get_lower_node(high);
+				upper._last_node->right = (high == nullptr) ? upper._last_node : max;
+
+				if (Node::counted)
+					_size = Node::count_of(low);
+				else
+					_size = _countLower(upper);
+				upper._size = total - _size;
+			}
+
+			// Appends the values of x, whose keys all sort after ours, leaving
+			// x empty; the first one links both trees
+			void join(self& x)
+			{
+				if (x._size == 0)
+					return ;
+				if (_size == 0)
 				{
-					if (node->value.first == to_remove.first)
+					swap(x);
+					return ;
+				}
+
+				node_pointer max = x._last_node->right;
+				node_pointer mid = x.extractNode(x._last_node->left);
+				node_pointer right = x._last_node->parent();
+
+				Balance::join(_last_node->parent(), mid, right, _last_node);
+				_last_node->right = max;
+				_size += x._size + 1;
+
+				x._last_node->set_parent(nullptr);
+				x._last_node->left = x._last_node;
+				x._last_node->right = x._last_node;
+				x._size = 0;
+			}
+
+			/*
+			** Order statistics, only with an ft::order_statistics node: any
+			** other node fails to compile here instead of walking blind
+			*/
+
+			// Node at in-order position n, _last_node if n >= size()
+			node_pointer select(size_type n) const
+			{
+				static_assert(Node::counted, "order statistics need an ft::order_statistics node");
+				node_pointer node = _last_node->parent();
+
+				if (n >= _size)
+					return (_last_node);
+				while (true)
+				{
+					size_type left = Node::count_of(node->left);
+					if (n == left)
 						return (node);
-					if (node->value.first > to_remove.first)
+					if (n < left)
 						node = node->left;
 					else
+					{
+						n -= left + 1;
 						node = node->right;
+					}
 				}
-				return (node);
+			}
+
+			// Number of keys less than key, i.e. the position of lowerBound(key)
+			template < class K >
+			size_type rank(const K& key) const
+			{
+				static_assert(Node::counted, "order statistics need an ft::order_statistics node");
+				node_pointer node = _last_node->parent();
+				size_type before = 0;
+
+				while (node != nullptr)
+				{
+					if (_comp(_key(node), key))
+					{
+						before += Node::count_of(node->left) + 1;
+						node = node->right;
+					}
+					else
+						node = node->left;
+				}
+				return (before);
+			}
+
+			// In-order position of node, size() for _last_node
+			size_type indexOf(node_pointer node) const
+			{
+				static_assert(Node::counted, "order statistics need an ft::order_statistics node");
+				if (node == _last_node)
+					return (_size);
+
+				size_type index = Node::count_of(node->left);
+				while (node->parent() != _last_node)
+				{
+					if (node == node->parent()->right)
+						index += Node::count_of(node->parent()->left) + 1;
+					node = node->parent();
+				}
+				return (index);
+			}
+
+			// Structural copy: same shape and metadata as x, without a single
+			// comparison. Nodes this tree already owns are recycled first.
+			void copy(const self& x)
+			{
+				if (&x == this)
+					return ;
+
+				node_pointer reuse = _detachNodes();
+				node_pointer src = x._last_node->parent();
+
+				if (src != nullptr)
+				{
+					node_pointer dst = _cloneNode(src, _last_node, reuse);
+					_last_node->set_parent(dst);
+					// dst children still nullptr = that side of src has not been copied yet
+					while (true)
+					{
+						if (src->left != nullptr && dst->left == nullptr)
+						{
+							dst->left = _cloneNode(src->left, dst, reuse);
+							src = src->left;
+							dst = dst->left;
+						}
+						else if (src->right != nullptr && dst->right == nullptr)
+						{
+							dst->right = _cloneNode(src->right, dst, reuse);
+							src = src->right;
+							dst = dst->right;
+						}
+						else if (src == x._last_node->parent())
+							break ;
+						else
+						{
+							src = src->parent();
+							dst = dst->parent();
+						}
+					}
+				}
+				_last_node->left = _BST_get_lower_node(_last_node->parent());
+				_last_node->right = _BST_get_higher_node(_last_node->parent());
+				_size = x._size;
+				_comp = x._comp;
+
+				while (reuse != nullptr)
+				{
+					node_pointer next = reuse->right;
+					_node_alloc.destroy(reuse);
+					_node_alloc.deallocate(reuse, 1);
+					reuse = next;
+				}
+			}
+
+			// Post-order teardown through the parent links: a node is freed as
+			// soon as both its subtrees are gone, no lookup and no rebalancing
+			void clear()
+			{
+				node_pointer node = _last_node->parent();
+
+				while (node != nullptr)
+				{
+					if (node->left != nullptr)
+						node = node->left;
+					else if (node->right != nullptr)
+						node = node->right;
+					else
+					{
+						node_pointer parent = node->parent();
+						if (parent == _last_node)
+							parent = nullptr;
+						else if (parent->left == node)
+							parent->left = nullptr;
+						else
+							parent->right = nullptr;
+						_node_alloc.destroy(node);
+						_node_alloc.deallocate(node, 1);
+						node = parent;
+					}
+				}
+				_last_node->set_parent(nullptr);
+				_last_node->left = _last_node;
+				_last_node->right = _last_node;
+				_size = 0;
+			}
+
+			// One iterative descent, then the node found is unlinked in place;
+			// with equal keys the whole equal range goes
+			size_type removeByKey(const key_type& to_remove)
+			{
+				if (!Keys::unique)
+				{
+					ft::pair<node_pointer, node_pointer> range = equalRange(to_remove);
+					size_type count = 0;
+
+					while (range.first != range.second)
+					{
+						node_pointer next = _successor(range.first);
+						_eraseNode(range.first);
+						range.first = next;
+						++count;
+					}
+					return (count);
+				}
+
+				node_pointer node = searchByKey(to_remove);
+
+				if (node == _last_node)
+					return (0);
+				_eraseNode(node);
+				return (1);
+			}
+
+			// node must belong to this tree (not _last_node): no lookup at all
+			void removeNode(node_pointer node)
+			{ _eraseNode(node); }
+
+			// Key-only lookup: K is key_type, or anything a transparent comparator accepts
+			template < class K >
+			node_pointer searchByKey(const K& key) const
+			{
+				node_pointer node = _last_node->parent();
+
+				while (node != nullptr)
+				{
+					if (_comp(key, _key(node)))
+						node = node->left;
+					else if (_comp(_key(node), key))
+						node = node->right;
+					else
+						return (node);
+				}
+				return (_last_node);
+			}
+
+			// First node whose key is not less than key, _last_node if none
+			template < class K >
+			node_pointer lowerBound(const K& key) const
+			{
+				node_pointer node = _last_node->parent();
+				node_pointer bound = _last_node;
+
+				while (node != nullptr)
+				{
+					if (!_comp(_key(node), key))
+					{
+						bound = node;
+						node = node->left;
+					}
+					else
+						node = node->right;
+				}
+				return (bound);
+			}
+
+			// First node whose key is greater than key, _last_node if none
+			template < class K >
+			node_pointer upperBound(const K& key) const
+			{
+				node_pointer node = _last_node->parent();
+				node_pointer bound = _last_node;
+
+				while (node != nullptr)
+				{
+					if (_comp(key, _key(node)))
+					{
+						bound = node;
+						node = node->left;
+					}
+					else
+						node = node->right;
+				}
+				return (bound);
+			}
+
+			// Both bounds in one descent: the paths only split at the first equal key
+			template < class K >
+			ft::pair<node_pointer, node_pointer> equalRange(const K& key) const
+			{
+				node_pointer node = _last_node->parent();
+				node_pointer upper = _last_node;
+
+				while (node != nullptr)
+				{
+					if (_comp(key, _key(node)))
+					{
+						upper = node;
+						node = node->left;
+					}
+					else if (_comp(_key(node), key))
+						node = node->right;
+					else
+					{
+						node_pointer lower = node;
+						node_pointer cursor = node->left;
+						while (cursor != nullptr)
+						{
+							if (!_comp(_key(cursor), key))
+							{
+								lower = cursor;
+								cursor = cursor->left;
+							}
+							else
+								cursor = cursor->right;
+						}
+						cursor = node->right;
+						while (cursor != nullptr)
+						{
+							if (_comp(key, _key(cursor)))
+							{
+								upper = cursor;
+								cursor = cursor->left;
+							}
+							else
+								cursor = cursor->right;
+						}
+						return (ft::make_pair(lower, upper));
+					}
+				}
+				return (ft::make_pair(upper, upper));
 			}
 
 			void swap(self& x)
@@ -159,126 +843,349 @@ namespace ft
 				node_pointer save = this->_last_node;
 				this->_last_node = x._last_node;
 				x._last_node = save;
+
+				size_type save_size = this->_size;
+				this->_size = x._size;
+				x._size = save_size;
+
+				key_compare save_comp = this->_comp;
+				this->_comp = x._comp;
+				x._comp = save_comp;
+
+				// nodes go along with the allocator they came from
+				node_alloc save_alloc = this->_node_alloc;
+				this->_node_alloc = x._node_alloc;
+				x._node_alloc = save_alloc;
 			}
 
+			size_type size() const
+			{ return (_size); }
+
+			key_compare key_comp() const
+			{ return (_comp); }
+
 			size_type max_size() const
-			{ return (node_alloc().max_size()); }
+			{ return (_node_alloc.max_size()); }
+
+			// Only available when Node_Alloc can pre-size itself (ft::node_pool)
+			void reserve(size_type n)
+			{ _node_alloc.reserve(n); }
 
 			// last_node parent = root of tree, last_node right = last node, last_node left = first node
+			// leaves hold nullptr, so the sentinel is never touched by the rebalancing policy
 			node_pointer    _last_node;
 			node_alloc      _node_alloc;
+			key_compare     _comp;
+			size_type       _size;
 
 		private :
 
-			node_pointer _BST_get_lower_node(node_pointer root)
+			static const key_type& _key(node_pointer node)
+			{ return (KeyOf::key(node->value)); }
+
+			// Equal keys: links to_insert as close to hint as the order allows,
+			// as std::multimap does: right before or right after it, else at
+			// the upper bound of its key (key <= hint) or the lower one
+			iterator _insertBefore(node_pointer hint, const value_type& to_insert)
 			{
-				while (root != _last_node && root->left != _last_node)
-					root = root->left;
-				return (root);
+				const key_type& key = KeyOf::key(to_insert);
+
+				if (_size == 0)
+					return (insertPair(to_insert).first);
+				if (hint == _last_node)
+				{
+					if (!_comp(key, _key(_last_node->right)))
+						return (_insertAt(_last_node->right, true, to_insert));
+					return (insertPair(to_insert).first);
+				}
+				if (!_comp(_key(hint), key))
+				{
+					if (hint == _last_node->left)
+						return (_insertAt(hint, false, to_insert));
+					node_pointer before = _predecessor(hint);
+					if (_comp(key, _key(before)))
+						return (insertPair(to_insert).first);
+					if (before->right == nullptr)
+						return (_insertAt(before, true, to_insert));
+					return (_insertAt(hint, false, to_insert));
+				}
+				if (hint == _last_node->right)
+					return (_insertAt(hint, true, to_insert));
+				node_pointer after = _successor(hint);
+				if (_comp(_key(after), key))
+					return (_insertLower(to_insert));
+				if (hint->right == nullptr)
+					return (_insertAt(hint, true, to_insert));
+				return (_insertAt(after, false, to_insert));
 			}
 
-			node_pointer _BST_get_higher_node(node_pointer root)
+			// Equal keys: links to_insert before its equals (lower bound position)
+			iterator _insertLower(const value_type& to_insert)
 			{
-				while (root != _last_node && root->right != _last_node)
-					root = root->right;
-				return (root);
+				node_pointer parent = _last_node;
+				node_pointer node = _last_node->parent();
+				bool side = false;
+
+				while (node != nullptr)
+				{
+					parent = node;
+					side = _comp(_key(node), KeyOf::key(to_insert));
+					node = side ? node->right : node->left;
+				}
+				return (_insertAt(parent, side, to_insert));
 			}
 
-			void _replaceNodeInParent(node_pointer node, node_pointer new_node)
+			// Links a new node as the given child of parent (side == true = right)
+			iterator _insertAt(node_pointer parent, bool side, const value_type& to_insert)
 			{
-				if (node->parent != _last_node)
-				{
-					if (_last_node->parent == node)
-						_last_node->parent = new_node;
+				Node * new_node = _node_alloc.allocate(1);
+				_node_alloc.construct(new_node, Node(to_insert, parent, nullptr, nullptr));
+				return (_linkAt(parent, side, new_node));
+			}
 
-					if (node == node->parent->left)
-						node->parent->left = new_node;
-					else
-						node->parent->right = new_node;
+			// Same with a lone leaf that is already built
+			iterator _linkAt(node_pointer parent, bool side, node_pointer new_node)
+			{
+				new_node->set_parent(parent);
+
+				// the cached extremes only move when their own child slot is filled
+				if (parent == _last_node)
+				{
+					_last_node->set_parent(new_node);
+					_last_node->left = new_node;
+					_last_node->right = new_node;
+				}
+				else if (side == true)
+				{
+					parent->right = new_node;
+					if (parent == _last_node->right)
+						_last_node->right = new_node;
 				}
 				else
-					_last_node->parent = new_node;
+				{
+					parent->left = new_node;
+					if (parent == _last_node->left)
+						_last_node->left = new_node;
+				}
 
-				_last_node->left = _BST_get_lower_node(_last_node->parent);
-				_last_node->right = _BST_get_higher_node(_last_node->parent);
-				_last_node->value.first -= 1;
-				
-				new_node->parent = node->parent;
-				
-				_node_alloc.destroy(node);
-				_node_alloc.deallocate(node, 1);
+				parent->pull_path(_last_node);
+				Balance::insert_rebalance(new_node, _last_node);
+				_size += 1;
+				return (iterator(new_node, _last_node));
+			}
+
+			// Makes the n nodes chained from head to tail through right the
+			// whole tree, perfectly balanced
+			void _linkChain(node_pointer head, node_pointer tail, size_type n)
+			{
+				_last_node->left = head;
+				_last_node->right = tail;
+				_size = n;
+
+				size_type height = 0;
+				while ((size_type(1) << height) <= n)
+					height++;
+				bool perfect = ((n & (n + 1)) == 0);
+				int root_height;
+				_last_node->set_parent(_buildBalanced(head, n, 0, perfect ? height : height - 1, root_height));
+				_last_node->parent()->set_parent(_last_node);
 			}
 
-			void _replaceDoubleChildren(node_pointer& to_remove, node_pointer new_node)
+			// Turns the n first nodes of chain (linked through right) into a
+			// balanced subtree and moves chain past them. Nodes at red_depth sit
+			// on the incomplete bottom level of the whole tree.
+			node_pointer _buildBalanced(node_pointer& chain, size_type n, size_type depth,
+				size_type red_depth, int& height)
 			{
-				if (new_node->parent != _last_node)
+				if (n == 0)
 				{
-					if (new_node->parent != to_remove)
-						new_node->parent->left = new_node->right;
+					height = 0;
+					return (nullptr);
 				}
-				
-				new_node->parent = to_remove->parent;
-				if (to_remove->left != new_node)
-					new_node->left = to_remove->left;
-				if (to_remove->right != new_node)
-					new_node->right = to_remove->right;
 
-				if (to_remove->parent != _last_node)
+				int left_height;
+				int right_height;
+				size_type left_n = (n - 1) / 2;
+
+				node_pointer left = _buildBalanced(chain, left_n, depth + 1, red_depth, left_height);
+				node_pointer root = chain;
+				chain = chain->right;
+				node_pointer right = _buildBalanced(chain, n - 1 - left_n, depth + 1, red_depth, right_height);
+
+				root->left = left;
+				if (left != nullptr)
+					left->set_parent(root);
+				root->right = right;
+				if (right != nullptr)
+					right->set_parent(root);
+				root->pull();
+
+				Balance::built(root, depth == red_depth, left_height, right_height);
+				height = 1 + (left_height > right_height ? left_height : right_height);
+				return (root);
+			}
+
+			// Copy of src under parent, built in a recycled node when there is one
+			node_pointer _cloneNode(node_pointer src, node_pointer parent, node_pointer& reuse)
+			{
+				node_pointer new_node = reuse;
+
+				if (new_node != nullptr)
 				{
-					if (to_remove->parent->left == to_remove)
-						to_remove->parent->left = new_node;
-					else if (to_remove->parent->right == to_remove)
-						to_remove->parent->right = new_node;
+					reuse = reuse->right;
+					_node_alloc.destroy(new_node);
 				}
 				else
-					_last_node->parent = new_node;
-					
-				if (to_remove->left != _last_node && to_remove->left != new_node)
-					to_remove->left->parent = new_node;
-				if (to_remove->right != _last_node && to_remove->right != new_node)
-					to_remove->right->parent = new_node;
+					new_node = _node_alloc.allocate(1);
+				_node_alloc.construct(new_node, Node(src->value, parent, nullptr, nullptr));
+				new_node->set_meta(src->meta());
+				new_node->copy_stats(*src);
+				return (new_node);
+			}
 
-				if (to_remove->parent != _last_node)
+			// Empties the tree and returns its nodes, still constructed, as a
+			// chain linked through right. Right rotations flatten the tree in
+			// O(n) without recursion or extra memory.
+			node_pointer _detachNodes()
+			{
+				node_pointer node = _last_node->parent();
+				node_pointer chain = nullptr;
+
+				while (node != nullptr)
 				{
-					to_remove->left = _last_node;
-					to_remove->right = _last_node;
-					to_remove->parent = new_node;
+					if (node->left != nullptr)
+					{
+						node_pointer left = node->left;
+						node->left = left->right;
+						left->right = node;
+						node = left;
+					}
+					else
+					{
+						node_pointer next = node->right;
+						node->right = chain;
+						chain = node;
+						node = next;
+					}
 				}
+				_last_node->set_parent(nullptr);
+				_last_node->left = _last_node;
+				_last_node->right = _last_node;
+				_size = 0;
+				return (chain);
+			}
+
+			// In-order neighbours of a node of the tree, _last_node past the ends
+			node_pointer _successor(node_pointer node) const
+			{ return (ft::tree_next(node, _last_node)); }
 
-				_last_node->left = _BST_get_lower_node(_last_node->parent);
-				_last_node->right = _BST_get_higher_node(_last_node->parent);
-				_last_node->value.first -= 1;
+			node_pointer _predecessor(node_pointer node) const
+			{ return (ft::tree_prev(node, _last_node)); }
 
-				_node_alloc.destroy(to_remove);
-				_node_alloc.deallocate(to_remove, 1);
+			node_pointer _BST_get_lower_node(node_pointer root)
+			{
+				if (root == nullptr)
+					return (_last_node);
+				while (root->left != nullptr)
+					root = root->left;
+				return (root);
+			}
+
+			node_pointer _BST_get_higher_node(node_pointer root)
+			{
+				if (root == nullptr)
+					return (_last_node);
+				while (root->right != nullptr)
+					root = root->right;
+				return (root);
 			}
 
-			void _removeByKey(node_pointer node, value_type to_remove)
+			// Cuts the subtree under node, of the given height, into the keys
+			// less than key, joined under _last_node, and the others, joined
+			// under high_header. Heights go down the path and come back with
+			// each part, so every join only walks the difference of two heights
+			// and the whole split stays O(log n).
+			void _split(node_pointer node, int height, const key_type& key,
+				node_pointer& low, int& low_height, node_pointer& high, int& high_height,
+				node_pointer high_header)
 			{
-				if (to_remove.first < node->value.first)
+				if (node == nullptr)
 				{
-					_removeByKey(node->left, to_remove);
+					low = nullptr;
+					high = nullptr;
+					low_height = 0;
+					high_height = 0;
 					return ;
 				}
 
-				if (to_remove.first > node->value.first)
+				node_pointer left = node->left;
+				node_pointer right = node->right;
+				int left_height;
+				int right_height;
+
+				Balance::child_heights(node, height, left_height, right_height);
+				_makeLone(node);
+				if (_comp(_key(node), key))
 				{
-					_removeByKey(node->right, to_remove);
-					return ;
+					_split(right, right_height, key, low, low_height, high, high_height, high_header);
+					low_height = Balance::join(left, left_height, node, low, low_height, _last_node);
+					low = _last_node->parent();
 				}
+				else
+				{
+					_split(left, left_height, key, low, low_height, high, high_height, high_header);
+					high_height = Balance::join(high, high_height, node, right, right_height, high_header);
+					high = high_header->parent();
+				}
+			}
+
+			// Size of this tree once split from upper, walking both in step:
+			// O(size of the smaller one)
+			size_type _countLower(const self& upper) const
+			{
+				node_pointer low = _last_node->left;
+				node_pointer high = upper._last_node->left;
+				size_type n = 0;
 
-				if (node->left != _last_node && node->right != _last_node)
+				while (low != _last_node && high != upper._last_node)
 				{
-					node_pointer successor = _BST_get_lower_node(node->right);
-					_replaceDoubleChildren(node, successor);
-					return ;
+					low = _successor(low);
+					high = upper._successor(high);
+					n++;
 				}
-				else if (node->left != _last_node)
-					_replaceNodeInParent(node, node->left);
-				else if (node->right != _last_node)
-					_replaceNodeInParent(node, node->right);
-				else
-					_replaceNodeInParent(node, _last_node);
+				if (low == _last_node)
+					return (n);
+				return (_size - n);
+			}
+
+			// Resets an unlinked node into a lone leaf
+			static void _makeLone(node_pointer node)
+			{
+				node->left = nullptr;
+				node->right = nullptr;
+				node->set_parent(nullptr);
+				node->set_meta(0);
+				node->pull();
+			}
+
+			// Unlinks node through the balancing policy
+			void _unlinkNode(node_pointer node)
+			{
+				if (node == _last_node->left)
+					_last_node->left = _successor(node);
+				if (node == _last_node->right)
+					_last_node->right = _predecessor(node);
+
+				Balance::erase_rebalance(node, _last_node);
+				_size -= 1;
+			}
+
+			// Same, then frees it
+			void _eraseNode(node_pointer node)
+			{
+				_unlinkNode(node);
+				_node_alloc.destroy(node);
+				_node_alloc.deallocate(node, 1);
 			}
 	};
 }
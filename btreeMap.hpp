@@ -0,0 +1,1153 @@
+#ifndef BTREEMAP_HPP
+#define BTREEMAP_HPP
+
+#include "utils.hpp"
+#include "iterators.hpp"
+#include "pair.hpp"
+#include <memory>
+#include <functional>
+#include <new>
+#include <utility>
+
+namespace ft
+{
+	/*
+	** B+ tree nodes. Values only live in the leaves, which are chained in
+	** order (the chain is circular through the tree header, which plays the
+	** part of end()); inner nodes only hold separator keys: child i holds
+	** the keys in [key(i - 1), key(i)).
+	** Slots are raw storage, only the first count of them are constructed.
+	*/
+	struct btree_node
+	{
+		size_t count;
+	};
+
+	struct btree_leaf_link : public btree_node
+	{
+		btree_leaf_link* prev;
+		btree_leaf_link* next;
+	};
+
+	template < class Value, size_t Slots >
+	struct btree_leaf : public btree_leaf_link
+	{
+		typedef Value   value_type;
+
+		static const size_t slots = Slots;
+
+		value_type* values()
+		{ return (reinterpret_cast<value_type*>(_storage)); }
+
+		value_type& value(size_t i)
+		{ return (values()[i]); }
+
+		private :
+			alignas(value_type) unsigned char _storage[sizeof(value_type) * Slots];
+	};
+
+	template < class Key, size_t Slots >
+	struct btree_inner : public btree_node
+	{
+		static const size_t slots = Slots;
+
+		btree_node* children[Slots + 1];
+
+		Key* keys()
+		{ return (reinterpret_cast<Key*>(_storage)); }
+
+		Key& key(size_t i)
+		{ return (keys()[i]); }
+
+		private :
+			alignas(Key) unsigned char _storage[sizeof(Key) * Slots];
+	};
+
+	/*
+	** A position is a leaf and a slot in it; end() is the header at slot 0
+	*/
+	template < class Leaf >
+	class btree_iterator : ft::iterator< ft::bidirectional_iterator_tag, typename Leaf::value_type >
+	{
+		public :
+			typedef typename Leaf::value_type value_type;
+			typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::iterator_category iterator_category;
+			typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::difference_type   difference_type;
+			typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::pointer   pointer;
+			typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::reference reference;
+
+			btree_iterator() : _leaf(), _pos() {}
+
+			btree_iterator(btree_leaf_link* leaf, size_t pos) : _leaf(leaf), _pos(pos) {}
+
+			btree_iterator(const btree_iterator& it) : _leaf(it._leaf), _pos(it._pos) {}
+
+			~btree_iterator() {}
+
+			btree_iterator &operator=(const btree_iterator& it)
+			{
+				this->_leaf = it._leaf;
+				this->_pos = it._pos;
+				return (*this);
+			}
+
+			btree_leaf_link* leaf() const
+			{ return (this->_leaf); }
+
+			size_t pos() const
+			{ return (this->_pos); }
+
+			bool operator==(const btree_iterator& it) const
+			{ return (this->_leaf == it._leaf && this->_pos == it._pos); }
+
+			bool operator!=(const btree_iterator& it) const
+			{ return (!(*this == it)); }
+
+			reference operator*() const
+			{ return (static_cast<Leaf*>(_leaf)->value(_pos)); }
+
+			pointer operator->() const
+			{ return (&this->operator*()); }
+
+			btree_iterator& operator++(void)
+			{
+				if (_pos + 1 < _leaf->count)
+					_pos += 1;
+				else
+				{
+					_leaf = _leaf->next;
+					_pos = 0;
+				}
+				return (*this);
+			}
+
+			btree_iterator operator++(int)
+			{
+				btree_iterator tmp(*this);
+				operator++();
+				return (tmp);
+			}
+
+			btree_iterator& operator--(void)
+			{
+				if (_pos > 0)
+					_pos -= 1;
+				else
+				{
+					_leaf = _leaf->prev;
+					_pos = _leaf->count - 1;
+				}
+				return (*this);
+			}
+
+			btree_iterator operator--(int)
+			{
+				btree_iterator tmp(*this);
+				operator--();
+				return (tmp);
+			}
+
+		private :
+			btree_leaf_link*    _leaf;
+			size_t              _pos;
+	};
+
+	template < class Leaf >
+	class btree_const_iterator : ft::iterator< ft::bidirectional_iterator_tag, typename Leaf::value_type >
+	{
+		public :
+			typedef typename Leaf::value_type value_type;
+			typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::iterator_category iterator_category;
+			typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::difference_type   difference_type;
+			typedef const value_type*   pointer;
+			typedef const value_type&   reference;
+
+			btree_const_iterator() : _leaf(), _pos() {}
+
+			btree_const_iterator(btree_leaf_link* leaf, size_t pos) : _leaf(leaf), _pos(pos) {}
+
+			btree_const_iterator(const btree_const_iterator& it) : _leaf(it._leaf), _pos(it._pos) {}
+
+			btree_const_iterator(const btree_iterator<Leaf>& it) : _leaf(it.leaf()), _pos(it.pos()) {}
+
+			~btree_const_iterator() {}
+
+			btree_const_iterator &operator=(const btree_const_iterator& it)
+			{
+				this->_leaf = it._leaf;
+				this->_pos = it._pos;
+				return (*this);
+			}
+
+			btree_leaf_link* leaf() const
+			{ return (this->_leaf); }
+
+			size_t pos() const
+			{ return (this->_pos); }
+
+			bool operator==(const btree_const_iterator& it) const
+			{ return (this->_leaf == it._leaf && this->_pos == it._pos); }
+
+			bool operator!=(const btree_const_iterator& it) const
+			{ return (!(*this == it)); }
+
+			reference operator*() const
+			{ return (static_cast<Leaf*>(_leaf)->value(_pos)); }
+
+			pointer operator->() const
+			{ return (&this->operator*()); }
+
+			btree_const_iterator& operator++(void)
+			{
+				if (_pos + 1 < _leaf->count)
+					_pos += 1;
+				else
+				{
+					_leaf = _leaf->next;
+					_pos = 0;
+				}
+				return (*this);
+			}
+
+			btree_const_iterator operator++(int)
+			{
+				btree_const_iterator tmp(*this);
+				operator++();
+				return (tmp);
+			}
+
+			btree_const_iterator& operator--(void)
+			{
+				if (_pos > 0)
+					_pos -= 1;
+				else
+				{
+					_leaf = _leaf->prev;
+					_pos = _leaf->count - 1;
+				}
+				return (*this);
+			}
+
+			btree_const_iterator operator--(int)
+			{
+				btree_const_iterator tmp(*this);
+				operator--();
+				return (tmp);
+			}
+
+		private :
+			btree_leaf_link*    _leaf;
+			size_t              _pos;
+	};
+
+	/*
+	** ft::map interface over a B+ tree whose nodes take about NodeBytes:
+	** a lookup touches a handful of nodes, each scanned within a few cache
+	** lines, instead of one node (and one cache miss) per level.
+	** Inserts and erases move values inside their leaf, so unlike ft::map
+	** they invalidate iterators.
+	*/
+		template < class Key, class T, class Compare = std::less<Key>,
+				class Alloc = std::allocator<ft::pair<const Key, T> >,
+				size_t NodeBytes = 256 >
+	class btree_map
+	{
+		public:
+
+			typedef Key     key_type;
+
+			typedef T       mapped_type;
+
+			typedef ft::pair<key_type, mapped_type> value_type;
+
+			typedef Compare     key_compare;
+
+			class value_compare : ft::binary_function<value_type, value_type, bool>
+			{
+				friend class btree_map<key_type, mapped_type, key_compare, Alloc, NodeBytes>;
+
+				protected:
+					Compare comp;
+					value_compare (Compare c) : comp(c) {}
+
+				public:
+
+					bool operator() (const value_type& x, const value_type& y) const
+					{ return (comp(x.first, y.first)); }
+			};
+
+			typedef Alloc  allocator_type;
+
+			typedef typename allocator_type::reference   reference;
+
+			typedef typename allocator_type::const_reference const_reference;
+
+			typedef typename allocator_type::pointer     pointer;
+
+			typedef typename allocator_type::const_pointer const_pointer;
+
+			typedef size_t size_type;
+
+			/*
+			** Slots per node, never less than 4 so that splits and merges
+			** always have room to work with
+			*/
+			static const size_type leaf_slots = ((NodeBytes - sizeof(btree_leaf_link)) / sizeof(value_type) < 4)
+				? 4 : (NodeBytes - sizeof(btree_leaf_link)) / sizeof(value_type);
+
+			static const size_type inner_slots = ((NodeBytes - 2 * sizeof(void*)) / (sizeof(key_type) + sizeof(void*)) < 4)
+				? 4 : (NodeBytes - 2 * sizeof(void*)) / (sizeof(key_type) + sizeof(void*));
+
+			typedef ft::btree_leaf<value_type, leaf_slots> leaf_type;
+
+			typedef ft::btree_inner<key_type, inner_slots> inner_type;
+
+			typedef ft::btree_iterator<leaf_type> iterator;
+
+			typedef ft::btree_const_iterator<leaf_type> const_iterator;
+
+			typedef typename ft::reverse_iterator<iterator>    reverse_iterator;
+
+			typedef typename ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+			typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
+
+
+			// Constructors
+
+			explicit btree_map (const key_compare& comp = key_compare(),
+				const allocator_type& alloc = allocator_type())
+			:
+				_alloc(alloc),
+				_comp(comp),
+				_leaf_alloc(alloc),
+				_inner_alloc(alloc),
+				_root(nullptr),
+				_height(0),
+				_size(0)
+			{ _resetHeader(); }
+
+
+			template <class InputIterator>
+				btree_map (InputIterator first, InputIterator last,
+					const key_compare& comp = key_compare(),
+					const allocator_type& alloc = allocator_type(),
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			:
+				_alloc(alloc),
+				_comp(comp),
+				_leaf_alloc(alloc),
+				_inner_alloc(alloc),
+				_root(nullptr),
+				_height(0),
+				_size(0)
+			{
+				_resetHeader();
+				this->insert(first, last);
+			}
+
+
+			btree_map(const btree_map& x)
+			:
+				_alloc(x._alloc),
+				_comp(x._comp),
+				_leaf_alloc(x._alloc),
+				_inner_alloc(x._alloc),
+				_root(nullptr),
+				_height(0),
+				_size(0)
+			{
+				_resetHeader();
+				_copy(x);
+			}
+
+
+			// Destructor
+
+			~btree_map()
+			{ this->clear(); }
+
+
+			// Operator=
+
+			btree_map& operator= (const btree_map& x)
+			{
+				if (&x == this)
+					return (*this);
+				this->clear();
+				_comp = x._comp;
+				_copy(x);
+				return (*this);
+			}
+
+
+			// Iterators
+
+			iterator begin()
+			{ return (iterator(_header.next, 0)); }
+
+			const_iterator begin() const
+			{ return (const_iterator(_header.next, 0)); }
+
+
+			iterator end()
+			{ return (iterator(&_header, 0)); }
+
+			const_iterator end() const
+			{ return (const_iterator(const_cast<btree_leaf_link*>(&_header), 0)); }
+
+
+			reverse_iterator rbegin()
+			{ return (reverse_iterator(this->end())); }
+
+			const_reverse_iterator rbegin() const
+			{ return (const_reverse_iterator(this->end())); }
+
+
+			reverse_iterator rend()
+			{ return (reverse_iterator(this->begin())); }
+
+			const_reverse_iterator rend() const
+			{ return (const_reverse_iterator(this->begin())); }
+
+
+			// Capacity
+
+			bool empty() const
+			{ return (_size == 0); }
+
+
+			size_type size() const
+			{ return (_size); }
+
+
+			size_type max_size() const
+			{ return (_leaf_alloc.max_size() * leaf_slots); }
+
+
+			// Element access
+
+			// One descent, mapped_type() is built in the leaf when k is missing
+			mapped_type& operator[] (const key_type& k)
+			{ return (_insertUnique(k, ft::in_place_t(), k).first->second); }
+
+
+			// Modifiers
+
+			pair<iterator,bool> insert (const value_type& val)
+			{ return (_insertUnique(val.first, val)); }
+
+			// Goes straight into the leaf of position (or the one before it)
+			// when val belongs there and the leaf has room, without a descent
+			iterator insert (iterator position, const value_type& val)
+			{
+				leaf_type* leaf = _hintLeaf(position, val.first);
+
+				if (leaf == nullptr)
+					return (this->insert(val).first);
+
+				size_type pos = _lowerSlot(leaf, val.first);
+				if (pos == leaf->count || _comp(val.first, leaf->value(pos).first))
+					_insertSlot(leaf, pos, val);
+				return (iterator(leaf, pos));
+			}
+
+			template <class InputIterator>
+				void insert (InputIterator first, InputIterator last,
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			{
+				for (; first != last; ++first)
+					this->insert(*first);
+			}
+
+
+			// Erases in the leaf of position unless that leaf would underflow,
+			// which needs the path to its siblings
+			void erase (iterator position)
+			{
+				leaf_type* leaf = static_cast<leaf_type*>(position.leaf());
+
+				if (_height == 0 || leaf->count > _leaf_min)
+					_eraseSlot(leaf, position.pos(), nullptr);
+				else
+					this->erase(position->first);
+			}
+
+			size_type erase (const key_type& k)
+			{
+				if (_root == nullptr)
+					return (0);
+
+				path_entry path[_max_height];
+				leaf_type* leaf = _descend(k, path);
+				size_type pos = _lowerSlot(leaf, k);
+
+				if (pos == leaf->count || _comp(k, leaf->value(pos).first))
+					return (0);
+				_eraseSlot(leaf, pos, path);
+				return (1);
+			}
+
+			// Values move on every erase: walk by key, one descent per value
+			void erase (iterator first, iterator last)
+			{
+				if (first == this->begin() && last == this->end())
+				{
+					this->clear();
+					return ;
+				}
+
+				size_type n = ft::distance(first, last);
+				if (n == 0)
+					return ;
+
+				key_type k = first->first;
+				while (true)
+				{
+					this->erase(k);
+					if (--n == 0)
+						break ;
+					k = this->lower_bound(k)->first;
+				}
+			}
+
+
+			void swap (btree_map& x)
+			{
+				_swap(_root, x._root);
+				_swap(_height, x._height);
+				_swap(_size, x._size);
+				_swap(_comp, x._comp);
+				_swap(_header, x._header);
+				_relinkHeader();
+				x._relinkHeader();
+			}
+
+
+			void clear()
+			{
+				if (_root != nullptr)
+					_destroy(_root, _height);
+				_root = nullptr;
+				_height = 0;
+				_size = 0;
+				_resetHeader();
+			}
+
+
+			// Observers
+
+			key_compare key_comp() const
+			{ return (_comp); }
+
+
+			value_compare value_comp() const
+			{ return (value_compare(_comp)); }
+
+
+			// Operations
+
+			iterator find (const key_type& k)
+			{ return (_find<iterator>(k)); }
+
+			const_iterator find (const key_type& k) const
+			{ return (_find<const_iterator>(k)); }
+
+
+			size_type count (const key_type& k) const
+			{ return (this->find(k) != this->end()); }
+
+
+			iterator lower_bound (const key_type& k)
+			{ return (_lowerBound<iterator>(k)); }
+
+			const_iterator lower_bound (const key_type& k) const
+			{ return (_lowerBound<const_iterator>(k)); }
+
+
+			iterator upper_bound (const key_type& k)
+			{ return (_upperBound<iterator>(k)); }
+
+			const_iterator upper_bound (const key_type& k) const
+			{ return (_upperBound<const_iterator>(k)); }
+
+
+			ft::pair<const_iterator, const_iterator> equal_range (const key_type& k) const
+			{ return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+
+			ft::pair<iterator, iterator> equal_range (const key_type& k)
+			{ return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+
+			// Allocator:
+			allocator_type get_allocator() const { return _alloc; }
+
+		private:
+
+			typedef typename Alloc::template rebind<leaf_type>::other leaf_alloc;
+
+			typedef typename Alloc::template rebind<inner_type>::other inner_alloc;
+
+			// Inner node crossed during a descent and the child taken there
+			struct path_entry
+			{
+				inner_type* node;
+				size_type   index;
+			};
+
+			// Every inner node but the root has at least 3 children
+			static const size_type _max_height = 48;
+
+			static const size_type _leaf_min = leaf_slots / 2;
+
+			static const size_type _inner_min = inner_slots / 2;
+
+			allocator_type                          _alloc;
+			Compare                                 _comp;
+			leaf_alloc                              _leaf_alloc;
+			inner_alloc                             _inner_alloc;
+			btree_node*                             _root;
+			size_type                               _height;
+			size_type                               _size;
+			btree_leaf_link                         _header;
+
+			template < class U >
+			static void _swap(U& a, U& b)
+			{
+				U tmp = a;
+				a = b;
+				b = tmp;
+			}
+
+			void _resetHeader()
+			{
+				_header.count = 0;
+				_header.prev = &_header;
+				_header.next = &_header;
+			}
+
+			// Points the first and last leaves back at this header after a swap
+			void _relinkHeader()
+			{
+				if (_root == nullptr)
+				{
+					_resetHeader();
+					return ;
+				}
+				_header.next->prev = &_header;
+				_header.prev->next = &_header;
+			}
+
+			// Moves the n objects at from to to, ranges may overlap
+			template < class U >
+			static void _relocate(U* from, size_type n, U* to)
+			{
+				if (to < from)
+				{
+					for (size_type i = 0; i < n; ++i)
+					{
+						new (static_cast<void*>(to + i)) U(from[i]);
+						from[i].~U();
+					}
+				}
+				else
+				{
+					for (size_type i = n; i > 0; --i)
+					{
+						new (static_cast<void*>(to + i - 1)) U(from[i - 1]);
+						from[i - 1].~U();
+					}
+				}
+			}
+
+			// Leaf of the hint where k may go without breaking the separators
+			// above it: between its first and last keys, or past the end of the
+			// first or last leaf. nullptr when there is none or it is full.
+			leaf_type* _hintLeaf(iterator position, const key_type& k)
+			{
+				if (_root == nullptr)
+					return (nullptr);
+
+				btree_leaf_link* link = position.leaf();
+				if (link == &_header)
+					link = _header.prev;
+				else if (position.pos() == 0 && link->prev != &_header
+					&& _comp(k, static_cast<leaf_type*>(link)->value(0).first))
+					link = link->prev;
+
+				leaf_type* leaf = static_cast<leaf_type*>(link);
+				if (leaf->count == leaf_slots)
+					return (nullptr);
+				if (leaf->prev != &_header && _comp(k, leaf->value(0).first))
+					return (nullptr);
+				if (leaf->next != &_header && _comp(leaf->value(leaf->count - 1).first, k))
+					return (nullptr);
+				return (leaf);
+			}
+
+			// Takes over the shape of x, node for node; this must be empty
+			void _copy(const btree_map& x)
+			{
+				if (x._root == nullptr)
+					return ;
+
+				btree_leaf_link* tail = &_header;
+				_root = _clone(x._root, x._height, tail);
+				tail->next = &_header;
+				_header.prev = tail;
+				_height = x._height;
+				_size = x._size;
+			}
+
+			// Copies the subtree of node, chaining its leaves after tail
+			btree_node* _clone(btree_node* node, size_type height, btree_leaf_link*& tail)
+			{
+				if (height == 0)
+				{
+					leaf_type* src = static_cast<leaf_type*>(node);
+					leaf_type* leaf = _newLeaf();
+					for (; leaf->count < src->count; ++leaf->count)
+						new (static_cast<void*>(leaf->values() + leaf->count)) value_type(src->value(leaf->count));
+					leaf->prev = tail;
+					tail->next = leaf;
+					tail = leaf;
+					return (leaf);
+				}
+
+				inner_type* src = static_cast<inner_type*>(node);
+				inner_type* inner = _newInner();
+				for (size_type i = 0; i <= src->count; ++i)
+					inner->children[i] = _clone(src->children[i], height - 1, tail);
+				for (; inner->count < src->count; ++inner->count)
+					new (static_cast<void*>(inner->keys() + inner->count)) key_type(src->key(inner->count));
+				return (inner);
+			}
+
+			leaf_type* _newLeaf()
+			{
+				leaf_type* leaf = _leaf_alloc.allocate(1);
+				new (static_cast<void*>(leaf)) leaf_type;
+				leaf->count = 0;
+				return (leaf);
+			}
+
+			inner_type* _newInner()
+			{
+				inner_type* inner = _inner_alloc.allocate(1);
+				new (static_cast<void*>(inner)) inner_type;
+				inner->count = 0;
+				return (inner);
+			}
+
+			void _destroy(btree_node* node, size_type height)
+			{
+				if (height == 0)
+				{
+					leaf_type* leaf = static_cast<leaf_type*>(node);
+					for (size_type i = 0; i < leaf->count; ++i)
+						leaf->value(i).~value_type();
+					_leaf_alloc.deallocate(leaf, 1);
+					return ;
+				}
+
+				inner_type* inner = static_cast<inner_type*>(node);
+				for (size_type i = 0; i <= inner->count; ++i)
+					_destroy(inner->children[i], height - 1);
+				for (size_type i = 0; i < inner->count; ++i)
+					inner->key(i).~key_type();
+				_inner_alloc.deallocate(inner, 1);
+			}
+
+			// First slot whose key is not less than k (binary search)
+			size_type _lowerSlot(leaf_type* leaf, const key_type& k) const
+			{
+				size_type low = 0;
+				size_type high = leaf->count;
+
+				while (low < high)
+				{
+					size_type mid = (low + high) / 2;
+					if (_comp(leaf->value(mid).first, k))
+						low = mid + 1;
+					else
+						high = mid;
+				}
+				return (low);
+			}
+
+			// First slot whose key is greater than k
+			size_type _upperSlot(leaf_type* leaf, const key_type& k) const
+			{
+				size_type low = 0;
+				size_type high = leaf->count;
+
+				while (low < high)
+				{
+					size_type mid = (low + high) / 2;
+					if (_comp(k, leaf->value(mid).first))
+						high = mid;
+					else
+						low = mid + 1;
+				}
+				return (low);
+			}
+
+			// Child of inner that may hold k
+			size_type _childIndex(inner_type* inner, const key_type& k) const
+			{
+				size_type low = 0;
+				size_type high = inner->count;
+
+				while (low < high)
+				{
+					size_type mid = (low + high) / 2;
+					if (_comp(k, inner->key(mid)))
+						high = mid;
+					else
+						low = mid + 1;
+				}
+				return (low);
+			}
+
+			// Leaf that may hold k, path (when given) records the inner nodes crossed
+			leaf_type* _descend(const key_type& k, path_entry* path) const
+			{
+				btree_node* node = _root;
+
+				for (size_type depth = 0; depth < _height; ++depth)
+				{
+					inner_type* inner = static_cast<inner_type*>(node);
+					size_type i = _childIndex(inner, k);
+					if (path != nullptr)
+					{
+						path[depth].node = inner;
+						path[depth].index = i;
+					}
+					node = inner->children[i];
+				}
+				return (static_cast<leaf_type*>(node));
+			}
+
+			template < class It >
+			It _find(const key_type& k) const
+			{
+				if (_root == nullptr)
+					return (It(const_cast<btree_leaf_link*>(&_header), 0));
+
+				leaf_type* leaf = _descend(k, nullptr);
+				size_type pos = _lowerSlot(leaf, k);
+
+				if (pos == leaf->count || _comp(k, leaf->value(pos).first))
+					return (It(const_cast<btree_leaf_link*>(&_header), 0));
+				return (It(leaf, pos));
+			}
+
+			// Every key of the next leaf is at least the separator k went left of
+			template < class It >
+			It _lowerBound(const key_type& k) const
+			{
+				if (_root == nullptr)
+					return (It(const_cast<btree_leaf_link*>(&_header), 0));
+
+				leaf_type* leaf = _descend(k, nullptr);
+				size_type pos = _lowerSlot(leaf, k);
+
+				if (pos == leaf->count)
+					return (It(leaf->next, 0));
+				return (It(leaf, pos));
+			}
+
+			template < class It >
+			It _upperBound(const key_type& k) const
+			{
+				if (_root == nullptr)
+					return (It(const_cast<btree_leaf_link*>(&_header), 0));
+
+				leaf_type* leaf = _descend(k, nullptr);
+				size_type pos = _upperSlot(leaf, k);
+
+				if (pos == leaf->count)
+					return (It(leaf->next, 0));
+				return (It(leaf, pos));
+			}
+
+			// Puts the value built from args where k goes, unless k is there
+			template <class... Args>
+				pair<iterator,bool> _insertUnique (const key_type& k, Args&&... args)
+			{
+				if (_root == nullptr)
+				{
+					leaf_type* leaf = _newLeaf();
+					leaf->prev = &_header;
+					leaf->next = &_header;
+					_header.prev = leaf;
+					_header.next = leaf;
+					_root = leaf;
+				}
+
+				path_entry path[_max_height];
+				leaf_type* leaf = _descend(k, path);
+				size_type pos = _lowerSlot(leaf, k);
+
+				if (pos < leaf->count && !_comp(k, leaf->value(pos).first))
+					return (ft::make_pair(iterator(leaf, pos), false));
+				if (leaf->count < leaf_slots)
+				{
+					_insertSlot(leaf, pos, std::forward<Args>(args)...);
+					return (ft::make_pair(iterator(leaf, pos), true));
+				}
+
+				leaf_type* right = _splitLeaf(leaf, pos);
+				if (pos > leaf->count || leaf->count == leaf_slots)
+				{
+					pos -= leaf->count;
+					leaf = right;
+				}
+				_insertSlot(leaf, pos, std::forward<Args>(args)...);
+				_insertSeparator(path, right->value(0).first, right);
+				return (ft::make_pair(iterator(leaf, pos), true));
+			}
+
+			template <class... Args>
+				void _insertSlot(leaf_type* leaf, size_type pos, Args&&... args)
+			{
+				_relocate(leaf->values() + pos, leaf->count - pos, leaf->values() + pos + 1);
+				new (static_cast<void*>(leaf->values() + pos)) value_type(std::forward<Args>(args)...);
+				leaf->count += 1;
+				_size += 1;
+			}
+
+			// Moves the upper half of a full leaf to a new leaf chained after it.
+			// Appending past the last value keeps the leaf full, so ascending
+			// inserts fill every leaf.
+			leaf_type* _splitLeaf(leaf_type* leaf, size_type pos)
+			{
+				leaf_type* right = _newLeaf();
+				size_type keep = leaf->count / 2;
+
+				if (pos == leaf->count && leaf->next == &_header)
+					keep = leaf->count;
+				_relocate(leaf->values() + keep, leaf->count - keep, right->values());
+				right->count = leaf->count - keep;
+				leaf->count = keep;
+
+				right->prev = leaf;
+				right->next = leaf->next;
+				leaf->next->prev = right;
+				leaf->next = right;
+				return (right);
+			}
+
+			// Adds key and child right after inner->children[i]
+			static void _insertKey(inner_type* inner, size_type i, const key_type& key, btree_node* child)
+			{
+				_relocate(inner->keys() + i, inner->count - i, inner->keys() + i + 1);
+				for (size_type j = inner->count + 1; j > i + 1; --j)
+					inner->children[j] = inner->children[j - 1];
+				new (static_cast<void*>(inner->keys() + i)) key_type(key);
+				inner->children[i + 1] = child;
+				inner->count += 1;
+			}
+
+			// Removes key(i) and children[i + 1]
+			static void _removeKey(inner_type* inner, size_type i)
+			{
+				inner->key(i).~key_type();
+				_relocate(inner->keys() + i + 1, inner->count - i - 1, inner->keys() + i);
+				for (size_type j = i + 1; j < inner->count; ++j)
+					inner->children[j] = inner->children[j + 1];
+				inner->count -= 1;
+			}
+
+			// child has just been split off the child the descent took at the
+			// bottom of path: hooks it in, splitting full inner nodes upwards
+			void _insertSeparator(path_entry* path, const key_type& separator, btree_node* child)
+			{
+				key_type key(separator);
+
+				for (size_type depth = _height; depth > 0; --depth)
+				{
+					inner_type* inner = path[depth - 1].node;
+					size_type i = path[depth - 1].index;
+
+					if (inner->count < inner_slots)
+					{
+						_insertKey(inner, i, key, child);
+						return ;
+					}
+
+					// key(mid) goes up, what is right of it moves to a new node
+					size_type mid = inner->count / 2;
+					inner_type* right = _newInner();
+
+					right->count = inner->count - mid - 1;
+					_relocate(inner->keys() + mid + 1, right->count, right->keys());
+					for (size_type j = 0; j <= right->count; ++j)
+						right->children[j] = inner->children[mid + 1 + j];
+					key_type up(inner->key(mid));
+					inner->key(mid).~key_type();
+					inner->count = mid;
+
+					if (i <= mid)
+						_insertKey(inner, i, key, child);
+					else
+						_insertKey(right, i - mid - 1, key, child);
+					key = up;
+					child = right;
+				}
+
+				inner_type* root = _newInner();
+				new (static_cast<void*>(root->keys())) key_type(key);
+				root->children[0] = _root;
+				root->children[1] = child;
+				root->count = 1;
+				_root = root;
+				_height += 1;
+			}
+
+			void _eraseSlot(leaf_type* leaf, size_type pos, path_entry* path)
+			{
+				leaf->value(pos).~value_type();
+				_relocate(leaf->values() + pos + 1, leaf->count - pos - 1, leaf->values() + pos);
+				leaf->count -= 1;
+				_size -= 1;
+
+				if (_height == 0)
+				{
+					if (leaf->count == 0)
+					{
+						_leaf_alloc.deallocate(leaf, 1);
+						_root = nullptr;
+						_resetHeader();
+					}
+					return ;
+				}
+				if (leaf->count >= _leaf_min)
+					return ;
+				if (_fixLeaf(leaf, path[_height - 1].node, path[_height - 1].index))
+					_fixInner(path);
+			}
+
+			// Refills an underfull leaf from a sibling, or merges it with one.
+			// Returns true when parent lost a key.
+			bool _fixLeaf(leaf_type* leaf, inner_type* parent, size_type i)
+			{
+				leaf_type* left = (i > 0) ? static_cast<leaf_type*>(parent->children[i - 1]) : nullptr;
+				leaf_type* right = (i < parent->count) ? static_cast<leaf_type*>(parent->children[i + 1]) : nullptr;
+
+				if (left != nullptr && left->count > _leaf_min)
+				{
+					_relocate(leaf->values(), leaf->count, leaf->values() + 1);
+					_relocate(left->values() + left->count - 1, 1, leaf->values());
+					left->count -= 1;
+					leaf->count += 1;
+					parent->key(i - 1) = leaf->value(0).first;
+					return (false);
+				}
+				if (right != nullptr && right->count > _leaf_min)
+				{
+					_relocate(right->values(), 1, leaf->values() + leaf->count);
+					_relocate(right->values() + 1, right->count - 1, right->values());
+					right->count -= 1;
+					leaf->count += 1;
+					parent->key(i) = right->value(0).first;
+					return (false);
+				}
+				if (left != nullptr)
+				{
+					_mergeLeaves(left, leaf);
+					_removeKey(parent, i - 1);
+				}
+				else
+				{
+					_mergeLeaves(leaf, right);
+					_removeKey(parent, i);
+				}
+				return (true);
+			}
+
+			void _mergeLeaves(leaf_type* left, leaf_type* right)
+			{
+				_relocate(right->values(), right->count, left->values() + left->count);
+				left->count += right->count;
+				left->next = right->next;
+				right->next->prev = left;
+				_leaf_alloc.deallocate(right, 1);
+			}
+
+			// Walks up from the leaf's parent while inner nodes are underfull
+			void _fixInner(path_entry* path)
+			{
+				for (size_type depth = _height - 1; depth > 0; --depth)
+				{
+					inner_type* node = path[depth].node;
+
+					if (node->count >= _inner_min)
+						return ;
+
+					inner_type* parent = path[depth - 1].node;
+					size_type i = path[depth - 1].index;
+					inner_type* left = (i > 0) ? static_cast<inner_type*>(parent->children[i - 1]) : nullptr;
+					inner_type* right = (i < parent->count) ? static_cast<inner_type*>(parent->children[i + 1]) : nullptr;
+
+					if (left != nullptr && left->count > _inner_min)
+					{
+						_relocate(node->keys(), node->count, node->keys() + 1);
+						for (size_type j = node->count + 1; j > 0; --j)
+							node->children[j] = node->children[j - 1];
+						new (static_cast<void*>(node->keys())) key_type(parent->key(i - 1));
+						node->children[0] = left->children[left->count];
+						parent->key(i - 1) = left->key(left->count - 1);
+						left->key(left->count - 1).~key_type();
+						left->count -= 1;
+						node->count += 1;
+						return ;
+					}
+					if (right != nullptr && right->count > _inner_min)
+					{
+						new (static_cast<void*>(node->keys() + node->count)) key_type(parent->key(i));
+						node->children[node->count + 1] = right->children[0];
+						node->count += 1;
+						parent->key(i) = right->key(0);
+						right->key(0).~key_type();
+						_relocate(right->keys() + 1, right->count - 1, right->keys());
+						for (size_type j = 0; j < right->count; ++j)
+							right->children[j] = right->children[j + 1];
+						right->count -= 1;
+						return ;
+					}
+					if (left != nullptr)
+					{
+						_mergeInner(left, node, parent->key(i - 1));
+						_removeKey(parent, i - 1);
+					}
+					else
+					{
+						_mergeInner(node, right, parent->key(i));
+						_removeKey(parent, i);
+					}
+				}
+
+				inner_type* root = static_cast<inner_type*>(_root);
+				if (root->count == 0)
+				{
+					_root = root->children[0];
+					_inner_alloc.deallocate(root, 1);
+					_height -= 1;
+				}
+			}
+
+			// Appends separator then right's keys and children to left
+			void _mergeInner(inner_type* left, inner_type* right, const key_type& separator)
+			{
+				new (static_cast<void*>(left->keys() + left->count)) key_type(separator);
+				_relocate(right->keys(), right->count, left->keys() + left->count + 1);
+				for (size_type j = 0; j <= right->count; ++j)
+					left->children[left->count + 1 + j] = right->children[j];
+				left->count += right->count + 1;
+				_inner_alloc.deallocate(right, 1);
+			}
+	};
+
+}
+
+#endif
@@ -0,0 +1,778 @@
+#ifndef CONCURRENTMAP_HPP
+#define CONCURRENTMAP_HPP
+
+#include "utils.hpp"
+#include "iterators.hpp"
+#include "pair.hpp"
+#include <atomic>
+#include <memory>
+#include <new>
+#include <thread>
+#include <cstddef>
+#include <functional>
+
+namespace ft
+{
+	/*
+	** Deferred freeing for readers that take no lock (two epochs).
+	** Every operation runs inside a guard counted in the epoch it started
+	** in; a node unlinked during epoch e is freed once the epoch has moved
+	** on to e + 1 and no guard of e is left, as nothing that started later
+	** can reach it. The epoch only moves while no guard of the previous one
+	** is left, so two counters (by parity) are enough. They are striped
+	** over cache lines by thread, readers on different cores never write
+	** to the same line.
+	*/
+	class epoch_domain
+	{
+		public:
+
+			static const size_t stripes = 64;
+
+			typedef std::atomic<long>* ticket;
+
+			epoch_domain()
+			:
+				_epoch(0)
+			{
+				for (size_t i = 0; i < stripes; ++i)
+				{
+					_guards[i].count[0].store(0, std::memory_order_relaxed);
+					_guards[i].count[1].store(0, std::memory_order_relaxed);
+				}
+			}
+
+			// Stripe of the calling thread
+			static size_t stripe()
+			{
+				static std::atomic<size_t> next(0);
+				static thread_local size_t id = next.fetch_add(1, std::memory_order_relaxed);
+
+				return (id % stripes);
+			}
+
+			ticket enter()
+			{
+				std::atomic<long>* count = nullptr;
+				size_t i = stripe();
+
+				for (;;)
+				{
+					unsigned long epoch = _epoch.load();
+					count = &_guards[i].count[epoch & 1];
+					count->fetch_add(1);
+					// Counted in the epoch only if it has not moved meanwhile
+					if (_epoch.load() == epoch)
+						return (count);
+					count->fetch_sub(1);
+				}
+			}
+
+			// One more guard counted in the epoch of count, which must have one
+			static void join(ticket count)
+			{ count->fetch_add(1, std::memory_order_relaxed); }
+
+			static void leave(ticket count)
+			{ count->fetch_sub(1, std::memory_order_release); }
+
+			unsigned long epoch() const
+			{ return (_epoch.load()); }
+
+			// No guard of epoch is left
+			bool idle(unsigned long epoch) const
+			{
+				long sum = 0;
+
+				for (size_t i = 0; i < stripes; ++i)
+					sum += _guards[i].count[epoch & 1].load();
+				return (sum == 0);
+			}
+
+			// By the one thread reclaiming, once idle(epoch() - 1)
+			void advance()
+			{ _epoch.fetch_add(1); }
+
+		private:
+
+			epoch_domain(const epoch_domain&);
+			epoch_domain& operator= (const epoch_domain&);
+
+			struct alignas(64) stripe_count
+			{
+				std::atomic<long>   count[2];
+			};
+
+			std::atomic<unsigned long>  _epoch;
+			stripe_count                _guards[stripes];
+	};
+
+	// Scoped epoch_domain::enter()
+	class epoch_guard
+	{
+		public:
+
+			explicit epoch_guard(epoch_domain& domain)
+			:
+				_ticket(domain.enter())
+			{}
+
+			~epoch_guard()
+			{ epoch_domain::leave(_ticket); }
+
+			epoch_domain::ticket ticket() const
+			{ return (_ticket); }
+
+		private:
+
+			epoch_guard(const epoch_guard&);
+			epoch_guard& operator= (const epoch_guard&);
+
+			epoch_domain::ticket    _ticket;
+	};
+
+	/*
+	** Skiplist node: its levels next links are laid out right after it, in
+	** the same block. marked is set when the node is logically removed,
+	** linked once it is in the list at every level; only writers take
+	** lock, and only for the few instructions that relink around it.
+	*/
+	template < class Value >
+	struct skiplist_node
+	{
+		typedef Value value_type;
+
+		typedef std::atomic<skiplist_node*> link_type;
+
+		value_type              value;
+		skiplist_node*          retired;
+		int                     levels;
+		std::atomic<bool>       marked;
+		std::atomic<bool>       linked;
+		std::atomic<bool>       locked;
+
+		skiplist_node(const value_type& val, int levels)
+		:
+			value(val), retired(nullptr), levels(levels), marked(false), linked(false), locked(false)
+		{
+			for (int i = 0; i < levels; ++i)
+				new (&this->next(i)) link_type(nullptr);
+		}
+
+		link_type& next(int level)
+		{ return (reinterpret_cast<link_type*>(this + 1)[level]); }
+
+		const link_type& next(int level) const
+		{ return (reinterpret_cast<const link_type*>(this + 1)[level]); }
+
+		// In the list, not being removed
+		bool live() const
+		{ return (linked.load(std::memory_order_acquire) && !marked.load(std::memory_order_acquire)); }
+
+		void lock()
+		{
+			while (locked.exchange(true, std::memory_order_acquire))
+				while (locked.load(std::memory_order_relaxed))
+					std::this_thread::yield();
+		}
+
+		void unlock()
+		{ locked.store(false, std::memory_order_release); }
+	};
+
+	/*
+	** Weakly consistent: walks the bottom level, skipping removed nodes.
+	** It sees every value present from its creation to its end, may or may
+	** not see values inserted or erased meanwhile, and never sees one
+	** twice. A non-end iterator counts as a guard of the epoch of the
+	** operation that made it: its node stays readable even once erased,
+	** but nothing erased after it was made is freed until it is destroyed,
+	** keep iterators short-lived.
+	*/
+	template < class Node >
+	class concurrent_iterator : ft::iterator< ft::forward_iterator_tag, typename Node::value_type >
+	{
+		public :
+			typedef typename Node::value_type value_type;
+			typedef typename ft::iterator<ft::forward_iterator_tag, value_type>::iterator_category iterator_category;
+			typedef typename ft::iterator<ft::forward_iterator_tag, value_type>::difference_type   difference_type;
+			typedef const value_type*   pointer;
+			typedef const value_type&   reference;
+
+			concurrent_iterator() : _ticket(nullptr), _node(nullptr) {}
+
+			// node was reached inside guard
+			concurrent_iterator(const epoch_guard& guard, const Node* node)
+			:
+				_ticket(node == nullptr ? nullptr : guard.ticket()),
+				_node(node)
+			{ _join(); }
+
+			concurrent_iterator(const concurrent_iterator& x)
+			:
+				_ticket(x._ticket),
+				_node(x._node)
+			{ _join(); }
+
+			~concurrent_iterator()
+			{ _leave(); }
+
+			concurrent_iterator& operator= (const concurrent_iterator& x)
+			{
+				if (&x == this)
+					return (*this);
+				_leave();
+				_ticket = x._ticket;
+				_node = x._node;
+				_join();
+				return (*this);
+			}
+
+			reference operator*() const { return (_node->value); }
+
+			pointer operator->() const { return (&_node->value); }
+
+			bool operator==(const concurrent_iterator& x) const { return (_node == x._node); }
+
+			bool operator!=(const concurrent_iterator& x) const { return (_node != x._node); }
+
+			concurrent_iterator& operator++()
+			{
+				do
+					_node = _node->next(0).load(std::memory_order_acquire);
+				while (_node != nullptr && !_node->live());
+				if (_node == nullptr)
+				{
+					_leave();
+					_ticket = nullptr;
+				}
+				return (*this);
+			}
+
+			concurrent_iterator operator++(int)
+			{
+				concurrent_iterator tmp(*this);
+				operator++();
+				return (tmp);
+			}
+
+		private :
+
+			void _join()
+			{
+				if (_ticket != nullptr)
+					epoch_domain::join(_ticket);
+			}
+
+			void _leave()
+			{
+				if (_ticket != nullptr)
+					epoch_domain::leave(_ticket);
+			}
+
+			epoch_domain::ticket    _ticket;
+			const Node*             _node;
+	};
+
+	/*
+	** Ordered map shared by many threads: a lazy skiplist. Lookups and
+	** iteration take no lock and write to no line shared with other cores; insert and erase
+	** lock only the nodes right before the one they link or unlink, so
+	** updates to distant keys never wait on each other. Values cannot be
+	** changed once inserted, as readers may be reading them: erase and
+	** insert again. size() is exact only while no update is running.
+	** Erased nodes are freed by the updates that come after, once no
+	** operation or iterator that could still see them is left.
+	** Alloc must be usable from several threads at once, as std::allocator.
+	** The map itself (constructor, destructor) is not shared.
+	*/
+	template < class Key, class T, class Compare = std::less<Key>,
+			class Alloc = std::allocator<ft::pair<const Key, T> > >
+	class concurrent_map
+	{
+		public:
+
+			typedef Key     key_type;
+
+			typedef T       mapped_type;
+
+			typedef ft::pair<key_type, mapped_type> value_type;
+
+			typedef Compare     key_compare;
+
+			class value_compare : ft::binary_function<value_type, value_type, bool>
+			{
+				friend class concurrent_map<key_type, mapped_type, key_compare, Alloc>;
+
+				protected:
+					Compare comp;
+					value_compare (Compare c) : comp(c) {}
+
+				public:
+
+					bool operator() (const value_type& x, const value_type& y) const
+					{ return (comp(x.first, y.first)); }
+			};
+
+			typedef Alloc  allocator_type;
+
+			typedef typename allocator_type::reference   reference;
+
+			typedef typename allocator_type::const_reference const_reference;
+
+			typedef typename allocator_type::pointer     pointer;
+
+			typedef typename allocator_type::const_pointer const_pointer;
+
+			typedef ft::skiplist_node<value_type> node_type;
+
+			typedef ft::concurrent_iterator<node_type> iterator;
+
+			typedef ft::concurrent_iterator<node_type> const_iterator;
+
+			typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
+
+			typedef size_t size_type;
+
+			// Half the nodes go up each level: 32 levels serve 2^32 values
+			static const int max_level = 32;
+
+
+			// Constructors
+
+			explicit concurrent_map (const key_compare& comp = key_compare(),
+				const allocator_type& alloc = allocator_type())
+			:
+				_alloc(alloc),
+				_comp(comp),
+				_head(_newNode(value_type(), max_level)),
+				_reclaiming(false)
+			{
+				for (size_t i = 0; i < epoch_domain::stripes; ++i)
+				{
+					_shards[i].size.store(0, std::memory_order_relaxed);
+					_shards[i].retired[0].store(nullptr, std::memory_order_relaxed);
+					_shards[i].retired[1].store(nullptr, std::memory_order_relaxed);
+					_shards[i].pending.store(0, std::memory_order_relaxed);
+				}
+			}
+
+
+			template <class InputIterator>
+				concurrent_map (InputIterator first, InputIterator last,
+					const key_compare& comp = key_compare(),
+					const allocator_type& alloc = allocator_type(),
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			:
+				concurrent_map(comp, alloc)
+			{ this->insert(first, last); }
+
+
+			// Destructor, no thread may still use the map
+
+			~concurrent_map()
+			{
+				node_pointer node = _head->next(0).load(std::memory_order_relaxed);
+
+				while (node != nullptr)
+				{
+					node_pointer next = node->next(0).load(std::memory_order_relaxed);
+					_deleteNode(node);
+					node = next;
+				}
+				for (size_t i = 0; i < epoch_domain::stripes; ++i)
+				{
+					_deleteList(_shards[i].retired[0].load(std::memory_order_relaxed));
+					_deleteList(_shards[i].retired[1].load(std::memory_order_relaxed));
+				}
+				_deleteNode(_head);
+			}
+
+
+			// Iterators
+
+			const_iterator begin() const
+			{
+				epoch_guard guard(_domain);
+				node_pointer node = _head->next(0).load(std::memory_order_acquire);
+
+				while (node != nullptr && !node->live())
+					node = node->next(0).load(std::memory_order_acquire);
+				return (const_iterator(guard, node));
+			}
+
+			const_iterator end() const
+			{ return (const_iterator()); }
+
+
+			// Capacity
+
+			bool empty() const
+			{ return (this->size() == 0); }
+
+
+			size_type size() const
+			{
+				long sum = 0;
+
+				for (size_t i = 0; i < epoch_domain::stripes; ++i)
+					sum += _shards[i].size.load(std::memory_order_relaxed);
+				return (sum < 0 ? 0 : static_cast<size_type>(sum));
+			}
+
+
+			size_type max_size() const
+			{ return (unit_allocator_type(_alloc).max_size() / (_units(1) + 1)); }
+
+
+			// Modifiers
+
+			ft::pair<const_iterator, bool> insert (const value_type& val)
+			{
+				epoch_guard guard(_domain);
+				node_pointer preds[max_level];
+				node_pointer succs[max_level];
+				node_pointer node = nullptr;
+				int levels = _randomLevel();
+
+				for (;;)
+				{
+					int found = _find(val.first, preds, succs);
+
+					if (found != -1)
+					{
+						node_pointer other = succs[found];
+
+						// Being erased: wait for it to be unlinked
+						if (other->marked.load(std::memory_order_acquire))
+						{
+							std::this_thread::yield();
+							continue ;
+						}
+						while (!other->linked.load(std::memory_order_acquire))
+							std::this_thread::yield();
+						if (node != nullptr)
+							_deleteNode(node);
+						return (ft::make_pair(const_iterator(guard, other), false));
+					}
+					if (node == nullptr)
+						node = _newNode(val, levels);
+
+					_lockPreds(preds, levels);
+					bool valid = true;
+
+					for (int level = 0; valid && level < levels; ++level)
+						valid = !preds[level]->marked.load(std::memory_order_acquire)
+							&& (succs[level] == nullptr || !succs[level]->marked.load(std::memory_order_acquire))
+							&& preds[level]->next(level).load(std::memory_order_acquire) == succs[level];
+					if (!valid)
+					{
+						_unlockPreds(preds, levels);
+						continue ;
+					}
+					for (int level = 0; level < levels; ++level)
+						node->next(level).store(succs[level], std::memory_order_relaxed);
+					for (int level = 0; level < levels; ++level)
+						preds[level]->next(level).store(node, std::memory_order_release);
+					node->linked.store(true, std::memory_order_release);
+					_unlockPreds(preds, levels);
+					_shard().size.fetch_add(1, std::memory_order_relaxed);
+					return (ft::make_pair(const_iterator(guard, node), true));
+				}
+			}
+
+			template <class InputIterator>
+				void insert (InputIterator first, InputIterator last,
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			{
+				for (; first != last; ++first)
+					this->insert(*first);
+			}
+
+
+			size_type erase (const key_type& k)
+			{
+				epoch_guard guard(_domain);
+				node_pointer preds[max_level];
+				node_pointer succs[max_level];
+				node_pointer victim = nullptr;
+
+				for (;;)
+				{
+					int found = _find(k, preds, succs);
+
+					if (victim == nullptr)
+					{
+						// Absent, still being inserted or already being erased
+						if (found == -1 || succs[found]->levels != found + 1 || !succs[found]->live())
+							return (0);
+						succs[found]->lock();
+						if (succs[found]->marked.load(std::memory_order_acquire))
+						{
+							succs[found]->unlock();
+							return (0);
+						}
+						victim = succs[found];
+						victim->marked.store(true, std::memory_order_release);
+					}
+
+					_lockPreds(preds, victim->levels);
+					bool valid = true;
+
+					for (int level = 0; valid && level < victim->levels; ++level)
+						valid = !preds[level]->marked.load(std::memory_order_acquire)
+							&& preds[level]->next(level).load(std::memory_order_acquire) == victim;
+					if (!valid)
+					{
+						_unlockPreds(preds, victim->levels);
+						continue ;
+					}
+					// Top down, so a search never finds it above a level it has left
+					for (int level = victim->levels - 1; level >= 0; --level)
+						preds[level]->next(level).store(victim->next(level).load(std::memory_order_acquire),
+							std::memory_order_release);
+					victim->unlock();
+					_unlockPreds(preds, victim->levels);
+					_shard().size.fetch_sub(1, std::memory_order_relaxed);
+					_retire(victim);
+					return (1);
+				}
+			}
+
+
+			// Observers
+
+			key_compare key_comp() const
+			{ return (_comp); }
+
+
+			value_compare value_comp() const
+			{ return (value_compare(_comp)); }
+
+
+			// Operations
+
+			const_iterator find (const key_type& k) const
+			{
+				epoch_guard guard(_domain);
+				node_pointer node = _lowerBound(k);
+
+				if (node != nullptr && _comp(k, node->value.first))
+					node = nullptr;
+				return (const_iterator(guard, node));
+			}
+
+
+			size_type count (const key_type& k) const
+			{
+				epoch_guard guard(_domain);
+				node_pointer node = _lowerBound(k);
+
+				return (node != nullptr && !_comp(k, node->value.first));
+			}
+
+
+			const_iterator lower_bound (const key_type& k) const
+			{
+				epoch_guard guard(_domain);
+
+				return (const_iterator(guard, _lowerBound(k)));
+			}
+
+
+			const_iterator upper_bound (const key_type& k) const
+			{
+				epoch_guard guard(_domain);
+				node_pointer node = _lowerBound(k);
+
+				while (node != nullptr && (!node->live() || !_comp(k, node->value.first)))
+					node = node->next(0).load(std::memory_order_acquire);
+				return (const_iterator(guard, node));
+			}
+
+			// Allocator:
+			allocator_type get_allocator() const { return _alloc; }
+
+		private:
+
+			concurrent_map(const concurrent_map&);
+			concurrent_map& operator= (const concurrent_map&);
+
+			typedef node_type* node_pointer;
+
+			typedef typename node_type::link_type link_type;
+
+			// A node and its links are allocated as one block of units
+			struct alignas(alignof(node_type) > alignof(link_type) ? alignof(node_type) : alignof(link_type)) unit
+			{
+				unsigned char bytes[sizeof(link_type)];
+			};
+
+			typedef typename Alloc::template rebind<unit>::other unit_allocator_type;
+
+			// Per stripe of threads, so updates on different cores share no line
+			struct alignas(64) shard
+			{
+				std::atomic<long>           size;
+				std::atomic<node_pointer>   retired[2];
+				std::atomic<size_t>         pending;
+			};
+
+			// Erased nodes a stripe gathers between two attempts at freeing
+			static const size_t reclaim_batch = 128;
+
+			allocator_type                  _alloc;
+			Compare                         _comp;
+			node_pointer                    _head;
+			mutable epoch_domain            _domain;
+			shard                           _shards[epoch_domain::stripes];
+			std::atomic<bool>               _reclaiming;
+
+			static size_t _units(int levels)
+			{ return ((sizeof(node_type) + levels * sizeof(link_type) + sizeof(unit) - 1) / sizeof(unit)); }
+
+			node_pointer _newNode(const value_type& val, int levels) const
+			{
+				unit_allocator_type alloc(_alloc);
+				unit* block = alloc.allocate(_units(levels));
+
+				return (new (static_cast<void*>(block)) node_type(val, levels));
+			}
+
+			void _deleteNode(node_pointer node) const
+			{
+				unit_allocator_type alloc(_alloc);
+				size_t units = _units(node->levels);
+
+				for (int i = 0; i < node->levels; ++i)
+					node->next(i).~link_type();
+				node->~node_type();
+				alloc.deallocate(reinterpret_cast<unit*>(node), units);
+			}
+
+			void _deleteList(node_pointer node) const
+			{
+				while (node != nullptr)
+				{
+					node_pointer next = node->retired;
+					_deleteNode(node);
+					node = next;
+				}
+			}
+
+			shard& _shard()
+			{ return (_shards[epoch_domain::stripe()]); }
+
+			// 1 + the number of trailing zero bits of a xorshift draw
+			static int _randomLevel()
+			{
+				static thread_local unsigned long long state = 0;
+				int levels = 1;
+
+				if (state == 0)
+					state = (reinterpret_cast<size_t>(&state) | 1) * 0x9E3779B97F4A7C15ULL;
+				state ^= state << 13;
+				state ^= state >> 7;
+				state ^= state << 17;
+				for (unsigned long long bits = state; (bits & 1) == 0 && levels < max_level; bits >>= 1)
+					++levels;
+				return (levels);
+			}
+
+			// Last node before k and the one after it, at every level; the
+			// highest level where a node with key k was met, or -1
+			int _find(const key_type& k, node_pointer* preds, node_pointer* succs) const
+			{
+				int found = -1;
+				node_pointer pred = _head;
+
+				for (int level = max_level - 1; level >= 0; --level)
+				{
+					node_pointer curr = pred->next(level).load(std::memory_order_acquire);
+
+					while (curr != nullptr && _comp(curr->value.first, k))
+					{
+						pred = curr;
+						curr = pred->next(level).load(std::memory_order_acquire);
+					}
+					if (found == -1 && curr != nullptr && !_comp(k, curr->value.first))
+						found = level;
+					preds[level] = pred;
+					succs[level] = curr;
+				}
+				return (found);
+			}
+
+			// First live node whose key is not less than k
+			node_pointer _lowerBound(const key_type& k) const
+			{
+				node_pointer pred = _head;
+				node_pointer curr = nullptr;
+
+				for (int level = max_level - 1; level >= 0; --level)
+				{
+					curr = pred->next(level).load(std::memory_order_acquire);
+					while (curr != nullptr && _comp(curr->value.first, k))
+					{
+						pred = curr;
+						curr = pred->next(level).load(std::memory_order_acquire);
+					}
+				}
+				while (curr != nullptr && !curr->live())
+					curr = curr->next(0).load(std::memory_order_acquire);
+				return (curr);
+			}
+
+			// Bottom up; a node that is the pred of several levels is locked once
+			static void _lockPreds(node_pointer* preds, int levels)
+			{
+				for (int level = 0; level < levels; ++level)
+					if (level == 0 || preds[level] != preds[level - 1])
+						preds[level]->lock();
+			}
+
+			static void _unlockPreds(node_pointer* preds, int levels)
+			{
+				for (int level = 0; level < levels; ++level)
+					if (level == 0 || preds[level] != preds[level - 1])
+						preds[level]->unlock();
+			}
+
+			/*
+			** Called inside the guard of the erase that unlinked node. The
+			** epoch read here cannot move twice before that guard leaves,
+			** so the node joins its list before the list can be freed.
+			*/
+			void _retire(node_pointer node)
+			{
+				shard& own = _shard();
+				std::atomic<node_pointer>& list = own.retired[_domain.epoch() & 1];
+
+				node->retired = list.load(std::memory_order_relaxed);
+				while (!list.compare_exchange_weak(node->retired, node,
+						std::memory_order_release, std::memory_order_relaxed))
+					;
+				if (own.pending.fetch_add(1, std::memory_order_relaxed) % reclaim_batch == reclaim_batch - 1)
+					_reclaim();
+			}
+
+			// Frees what was erased in the previous epoch if nothing can see
+			// it anymore, then opens the next epoch
+			void _reclaim()
+			{
+				if (_reclaiming.exchange(true, std::memory_order_acquire))
+					return ;
+
+				unsigned long epoch = _domain.epoch();
+
+				if (_domain.idle(epoch - 1))
+				{
+					for (size_t i = 0; i < epoch_domain::stripes; ++i)
+						_deleteList(_shards[i].retired[(epoch - 1) & 1].exchange(nullptr, std::memory_order_acquire));
+					_domain.advance();
+				}
+				_reclaiming.store(false, std::memory_order_release);
+			}
+	};
+}
+
+#endif
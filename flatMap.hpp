@@ -0,0 +1,467 @@
+#ifndef FLATMAP_HPP
+#define FLATMAP_HPP
+
+#include "utils.hpp"
+#include "iterators.hpp"
+#include "pair.hpp"
+#include "vector.hpp"
+#include <memory>
+#include <functional>
+
+namespace ft
+{
+	/*
+	** ft::map interface over a sorted ft::vector of pairs: lookups are
+	** binary searches over contiguous memory and there is no per element
+	** node. A single insert or erase shifts the values after it, so this is
+	** meant for maps built once (or in batches) and then mostly queried:
+	** a range insert appends, sorts and merges in one pass.
+	** Like for a vector, insert and erase invalidate iterators.
+	*/
+		template < class Key, class T, class Compare = std::less<Key>,
+				class Alloc = std::allocator<ft::pair<const Key, T> > >
+	class flat_map
+	{
+		public:
+
+			typedef Key     key_type;
+
+			typedef T       mapped_type;
+
+			typedef ft::pair<key_type, mapped_type> value_type;
+
+			typedef Compare     key_compare;
+
+			class value_compare : ft::binary_function<value_type, value_type, bool>
+			{
+				friend class flat_map<key_type, mapped_type, key_compare, Alloc>;
+
+				protected:
+					Compare comp;
+					value_compare (Compare c) : comp(c) {}
+
+				public:
+
+					bool operator() (const value_type& x, const value_type& y) const
+					{ return (comp(x.first, y.first)); }
+			};
+
+			typedef Alloc  allocator_type;
+
+			typedef typename allocator_type::reference   reference;
+
+			typedef typename allocator_type::const_reference const_reference;
+
+			typedef typename allocator_type::pointer     pointer;
+
+			typedef typename allocator_type::const_pointer const_pointer;
+
+			typedef ft::vector<value_type, typename Alloc::template rebind<value_type>::other> container_type;
+
+			typedef typename container_type::iterator iterator;
+
+			typedef typename container_type::const_iterator const_iterator;
+
+			typedef typename ft::reverse_iterator<iterator>    reverse_iterator;
+
+			typedef typename ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+			typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
+
+			typedef size_t size_type;
+
+
+			// Constructors
+
+			explicit flat_map (const key_compare& comp = key_compare(),
+				const allocator_type& alloc = allocator_type())
+			:
+				_alloc(alloc),
+				_comp(comp),
+				_values()
+			{}
+
+
+			template <class InputIterator>
+				flat_map (InputIterator first, InputIterator last,
+					const key_compare& comp = key_compare(),
+					const allocator_type& alloc = allocator_type(),
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			:
+				_alloc(alloc),
+				_comp(comp),
+				_values()
+			{ this->insert(first, last); }
+
+
+			flat_map(const flat_map& x)
+			:
+				_alloc(x._alloc),
+				_comp(x._comp),
+				_values()
+			{ _append(x._data(), x.size()); }
+
+
+			// Destructor
+
+			~flat_map()
+			{}
+
+
+			// Operator=
+
+			flat_map& operator= (const flat_map& x)
+			{
+				if (&x == this)
+					return (*this);
+				_values.clear();
+				_comp = x._comp;
+				_append(x._data(), x.size());
+				return (*this);
+			}
+
+
+			// Iterators
+
+			iterator begin()
+			{ return (iterator(_data())); }
+
+			const_iterator begin() const
+			{ return (const_iterator(_data())); }
+
+
+			iterator end()
+			{ return (iterator(_data() + _values.size())); }
+
+			const_iterator end() const
+			{ return (const_iterator(_data() + _values.size())); }
+
+
+			reverse_iterator rbegin()
+			{ return (reverse_iterator(this->end())); }
+
+			const_reverse_iterator rbegin() const
+			{ return (const_reverse_iterator(this->end())); }
+
+
+			reverse_iterator rend()
+			{ return (reverse_iterator(this->begin())); }
+
+			const_reverse_iterator rend() const
+			{ return (const_reverse_iterator(this->begin())); }
+
+
+			// Capacity
+
+			bool empty() const
+			{ return (_values.size() == 0); }
+
+
+			size_type size() const
+			{ return (_values.size()); }
+
+
+			size_type max_size() const
+			{ return (_values.max_size()); }
+
+
+			size_type capacity() const
+			{ return (_values.capacity()); }
+
+
+			void reserve(size_type n)
+			{ _values.reserve(n); }
+
+
+			// Element access
+
+			mapped_type& operator[] (const key_type& k)
+			{
+				size_type pos = _lowerBound(k);
+
+				if (pos == size() || _comp(k, _data()[pos].first))
+					_insertAt(pos, ft::make_pair(k, mapped_type()));
+				return (_data()[pos].second);
+			}
+
+
+			// Modifiers
+
+			pair<iterator,bool> insert (const value_type& val)
+			{
+				size_type pos = _lowerBound(val.first);
+
+				if (pos < size() && !_comp(val.first, _data()[pos].first))
+					return (ft::make_pair(iterator(_data() + pos), false));
+				_insertAt(pos, val);
+				return (ft::make_pair(iterator(_data() + pos), true));
+			}
+
+			// A right hint (val belongs just before position) skips the search
+			iterator insert (iterator position, const value_type& val)
+			{
+				size_type pos = position - this->begin();
+
+				if ((pos == size() || _comp(val.first, _data()[pos].first))
+					&& (pos == 0 || _comp(_data()[pos - 1].first, val.first)))
+				{
+					_insertAt(pos, val);
+					return (iterator(_data() + pos));
+				}
+				return (this->insert(val).first);
+			}
+
+			// Appends the whole range, then sorts and merges it in at once
+			template <class InputIterator>
+				void insert (InputIterator first, InputIterator last,
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			{
+				size_type old_size = size();
+
+				for (; first != last; ++first)
+					_values.push_back(*first);
+				_mergeTail(old_size);
+			}
+
+
+			void erase (iterator position)
+			{ _eraseAt(position - this->begin(), 1); }
+
+			size_type erase (const key_type& k)
+			{
+				size_type pos = _lowerBound(k);
+
+				if (pos == size() || _comp(k, _data()[pos].first))
+					return (0);
+				_eraseAt(pos, 1);
+				return (1);
+			}
+
+			void erase (iterator first, iterator last)
+			{ _eraseAt(first - this->begin(), last - first); }
+
+
+			void swap (flat_map& x)
+			{
+				_values.swap(x._values);
+
+				key_compare save_comp = _comp;
+				_comp = x._comp;
+				x._comp = save_comp;
+			}
+
+
+			void clear()
+			{ _values.clear(); }
+
+
+			// Observers
+
+			key_compare key_comp() const
+			{ return (_comp); }
+
+
+			value_compare value_comp() const
+			{ return (value_compare(_comp)); }
+
+
+			// Operations
+
+			iterator find (const key_type& k)
+			{ return (iterator(_data() + _find(k))); }
+
+			const_iterator find (const key_type& k) const
+			{ return (const_iterator(_data() + _find(k))); }
+
+
+			size_type count (const key_type& k) const
+			{ return (_find(k) != size()); }
+
+
+			iterator lower_bound (const key_type& k)
+			{ return (iterator(_data() + _lowerBound(k))); }
+
+			const_iterator lower_bound (const key_type& k) const
+			{ return (const_iterator(_data() + _lowerBound(k))); }
+
+
+			iterator upper_bound (const key_type& k)
+			{ return (iterator(_data() + _upperBound(k))); }
+
+			const_iterator upper_bound (const key_type& k) const
+			{ return (const_iterator(_data() + _upperBound(k))); }
+
+
+			ft::pair<const_iterator, const_iterator> equal_range (const key_type& k) const
+			{ return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+
+			ft::pair<iterator, iterator> equal_range (const key_type& k)
+			{ return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+
+			// Allocator:
+			allocator_type get_allocator() const { return _alloc; }
+
+		private:
+
+			allocator_type                          _alloc;
+			Compare                                 _comp;
+			container_type                          _values;
+
+			value_type* _data() const
+			{ return (const_cast<container_type&>(_values).begin().base()); }
+
+			void _append(const value_type* values, size_type n)
+			{
+				for (size_type i = 0; i < n; ++i)
+					_values.push_back(values[i]);
+			}
+
+			// First position whose key is not less than k
+			size_type _lowerBound(const key_type& k) const
+			{ return (_lowerBoundIn(_data(), size(), k)); }
+
+			// Same, in the n first values of data
+			size_type _lowerBoundIn(value_type* data, size_type n, const key_type& k) const
+			{
+				size_type low = 0;
+				size_type high = n;
+
+				while (low < high)
+				{
+					size_type mid = (low + high) / 2;
+					if (_comp(data[mid].first, k))
+						low = mid + 1;
+					else
+						high = mid;
+				}
+				return (low);
+			}
+
+			// First position whose key is greater than k
+			size_type _upperBound(const key_type& k) const
+			{
+				value_type* data = _data();
+				size_type low = 0;
+				size_type high = size();
+
+				while (low < high)
+				{
+					size_type mid = (low + high) / 2;
+					if (_comp(k, data[mid].first))
+						high = mid;
+					else
+						low = mid + 1;
+				}
+				return (low);
+			}
+
+			// Position of k, size() when absent
+			size_type _find(const key_type& k) const
+			{
+				size_type pos = _lowerBound(k);
+
+				if (pos == size() || _comp(k, _data()[pos].first))
+					return (size());
+				return (pos);
+			}
+
+			void _insertAt(size_type pos, const value_type& val)
+			{
+				value_type copy(val);
+
+				_values.push_back(copy);
+				value_type* data = _data();
+				for (size_type i = size() - 1; i > pos; --i)
+					data[i] = data[i - 1];
+				data[pos] = copy;
+			}
+
+			void _eraseAt(size_type pos, size_type n)
+			{
+				value_type* data = _data();
+
+				for (size_type i = pos; i + n < size(); ++i)
+					data[i] = data[i + n];
+				while (n-- > 0)
+					_values.pop_back();
+			}
+
+			// Sorts the n values of dst, src holds the same values and ends
+			// up clobbered. Stable: equal keys keep their order.
+			void _mergeSort(value_type* src, value_type* dst, size_type n)
+			{
+				if (n < 2)
+					return ;
+
+				size_type half = n / 2;
+				_mergeSort(dst, src, half);
+				_mergeSort(dst + half, src + half, n - half);
+
+				size_type i = 0;
+				size_type j = half;
+				for (size_type k = 0; k < n; ++k)
+				{
+					if (j == n || (i < half && !_comp(src[j].first, src[i].first)))
+						dst[k] = src[i++];
+					else
+						dst[k] = src[j++];
+				}
+			}
+
+			// Values past old_size have just been appended in any order:
+			// sorts them, drops those whose key is already there (the first
+			// one wins, as for repeated inserts) and merges them in from the
+			// back, so each value moves once
+			void _mergeTail(size_type old_size)
+			{
+				size_type added = size() - old_size;
+
+				if (added == 0)
+					return ;
+
+				value_type* tail = _data() + old_size;
+				container_type scratch;
+				for (size_type i = 0; i < added; ++i)
+					scratch.push_back(tail[i]);
+				_mergeSort(scratch.begin().base(), tail, added);
+
+				value_type* data = _data();
+				size_type kept = 0;
+				for (size_type i = 0; i < added; ++i)
+				{
+					if (kept > 0 && !_comp(tail[kept - 1].first, tail[i].first))
+						continue ;
+					if (old_size > 0)
+					{
+						size_type pos = _lowerBoundIn(data, old_size, tail[i].first);
+						if (pos < old_size && !_comp(tail[i].first, data[pos].first))
+							continue ;
+					}
+					if (kept != i)
+						tail[kept] = tail[i];
+					kept += 1;
+				}
+				for (size_type i = kept; i < added; ++i)
+					_values.pop_back();
+				if (old_size == 0 || kept == 0)
+					return ;
+
+				value_type* buffer = scratch.begin().base();
+				for (size_type i = 0; i < kept; ++i)
+					buffer[i] = tail[i];
+
+				size_type i = old_size;
+				size_type j = kept;
+				for (size_type k = old_size + kept; j > 0; --k)
+				{
+					if (i > 0 && _comp(buffer[j - 1].first, data[i - 1].first))
+						data[k - 1] = data[--i];
+					else
+						data[k - 1] = buffer[--j];
+				}
+			}
+	};
+
+}
+
+#endif
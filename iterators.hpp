@@ -92,6 +92,10 @@ namespace ft
 
                 random_access_iterator(const random_access_iterator& op) : _elem(op._elem) {}
 
+                // iterator to const_iterator
+                template < class U >
+                random_access_iterator(const random_access_iterator<U>& op) : _elem(op.base()) {}
+
                 random_access_iterator &operator=(const random_access_iterator& op)
                 {
                     if (this == &op)
@@ -452,8 +456,52 @@ namespace ft
     
     
     
-    /* Bidirectional iterators*/
-    template < class T, class Compare >
+    /*
+    ** In-order neighbours in a tree whose leaves are nullptr and whose
+    ** root hangs under last_node: pointer chasing only, no key comparison.
+    ** Climbing stops at the first ancestor reached from its left (next)
+    ** or right (prev) subtree, which is last_node past the ends.
+    */
+    template < class T >
+    T* tree_next(T* node, T* last_node)
+    {
+        if (node->right != nullptr)
+        {
+            node = node->right;
+            while (node->left != nullptr)
+                node = node->left;
+            return (node);
+        }
+        T* cursor = node->parent();
+        while (cursor != last_node && node == cursor->right)
+        {
+            node = cursor;
+            cursor = cursor->parent();
+        }
+        return (cursor);
+    }
+
+    template < class T >
+    T* tree_prev(T* node, T* last_node)
+    {
+        if (node->left != nullptr)
+        {
+            node = node->left;
+            while (node->right != nullptr)
+                node = node->right;
+            return (node);
+        }
+        T* cursor = node->parent();
+        while (cursor != last_node && node == cursor->left)
+        {
+            node = cursor;
+            cursor = cursor->parent();
+        }
+        return (cursor);
+    }
+
+    /* Bidirectional iterators, a node and the tree sentinel (end) */
+    template < class T >
     class BST_iterator : ft::iterator< ft::bidirectional_iterator_tag, T >
     {
         public :
@@ -463,28 +511,31 @@ namespace ft
             typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::pointer   pointer;
             typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::reference reference;
 
-            BST_iterator( const Compare& comp = Compare()) : _node(), _last_node(), _comp(comp) {}
+            BST_iterator() : _node(), _last_node() {}
 
-            BST_iterator(T* node_p, T* last_node, const Compare& comp = Compare()) : _node(node_p), _last_node(last_node), _comp(comp) {}
+            BST_iterator(T* node_p, T* last_node) : _node(node_p), _last_node(last_node) {}
 
-            BST_iterator(const BST_iterator& bst_it) : _node(bst_it._node), _last_node(bst_it._last_node), _comp() {}
+            BST_iterator(const BST_iterator& bst_it) : _node(bst_it._node), _last_node(bst_it._last_node) {}
 
-            virtual ~BST_iterator() {}
+            ~BST_iterator() {}
 
             BST_iterator &operator=(const BST_iterator& bst_it)
 			{
-				if (*this == bst_it)
-					return (*this);
 				this->_node = bst_it._node;
 				this->_last_node = bst_it._last_node;
-				this->_comp = bst_it._comp;
 				return (*this);
 			}
 
-            bool operator==(const BST_iterator& bst_it)
+            T* base() const
+			{ return (this->_node); }
+
+            T* last_node() const
+			{ return (this->_last_node); }
+
+            bool operator==(const BST_iterator& bst_it) const
 			{ return (this->_node == bst_it._node); }
 
-            bool operator!=(const BST_iterator& bst_it)
+            bool operator!=(const BST_iterator& bst_it) const
 			{ return (this->_node != bst_it._node); }
 
             reference operator*() const
@@ -495,28 +546,10 @@ namespace ft
 
             BST_iterator& operator++(void)
             {
-                T* cursor = _node;
-                if (_node->right == _last_node)
-                {
-                    cursor = _node->parent;
-                    while (cursor != _last_node && _comp(cursor->value.first, _node->value.first))
-                        cursor = cursor->parent;
-                    _node = cursor;
-                }
-                else if (cursor == _last_node)
+                if (_node == _last_node)
                     _node = _last_node->right;
                 else
-                {
-                    cursor = _node->right;
-                    if (cursor == _last_node->parent && cursor->right == _last_node)
-                        _node = cursor;
-                    else
-                    {
-                        while (cursor->left != _last_node)
-                            cursor = cursor->left;
-                    }
-                    _node = cursor;
-                }
+                    _node = ft::tree_next(_node, _last_node);
                 return (*this);
             }
 
@@ -529,29 +562,10 @@ namespace ft
 
             BST_iterator& operator--(void)
             {
-                T* cursor = _node;
-
-                if (_node->left == _last_node)
-                {
-                    cursor = _node->parent;
-                    while (cursor != _last_node && !_comp(cursor->value.first, _node->value.first))
-                        cursor = cursor->parent;
-                    _node = cursor;
-                }
-                else if (cursor == _last_node)
+                if (_node == _last_node)
                     _node = _last_node->right;
                 else
-                {
-                    cursor = _node->left;
-                    if (cursor == _last_node->parent && cursor->left == _last_node)
-                        _node = cursor;
-                    else
-                    {
-                        while (cursor->right != _last_node)
-                            cursor = cursor->right;
-                    }
-                    _node = cursor;
-                }
+                    _node = ft::tree_prev(_node, _last_node);
                 return (*this);
             }
 
@@ -565,10 +579,9 @@ namespace ft
         private :
             T* _node;
             T* _last_node;
-            Compare _comp;
     };
 
-    template < class T, class Compare >
+    template < class T >
     class BST_const_iterator : ft::iterator< ft::bidirectional_iterator_tag, T >
     {
         public :
@@ -578,28 +591,33 @@ namespace ft
             typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::pointer   pointer;
             typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::reference reference;
 
-            BST_const_iterator( const Compare& comp = Compare()) : _node(), _last_node(), _comp(comp) {}
+            BST_const_iterator() : _node(), _last_node() {}
+
+            BST_const_iterator(T* node_p, T* last_node) : _node(node_p), _last_node(last_node) {}
 
-            BST_const_iterator(T* node_p, T* last_node, const Compare& comp = Compare()) : _node(node_p), _last_node(last_node), _comp(comp) {}
+            BST_const_iterator(const BST_const_iterator& bst_it) : _node(bst_it._node), _last_node(bst_it._last_node) {}
 
-            BST_const_iterator(const BST_const_iterator& bst_it) : _node(bst_it._node), _last_node(bst_it._last_node), _comp() {}
+            BST_const_iterator(const BST_iterator<T>& bst_it) : _node(bst_it.base()), _last_node(bst_it.last_node()) {}
 
-            virtual ~BST_const_iterator() {}
+            ~BST_const_iterator() {}
 
             BST_const_iterator &operator=(const BST_const_iterator& bst_it)
 			{
-				if (*this == bst_it)
-					return (*this);
 				this->_node = bst_it._node;
 				this->_last_node = bst_it._last_node;
-				this->_comp = bst_it._comp;
 				return (*this);
 			}
 
-            bool operator==(const BST_const_iterator& bst_it)
+            T* base() const
+			{ return (this->_node); }
+
+            T* last_node() const
+			{ return (this->_last_node); }
+
+            bool operator==(const BST_const_iterator& bst_it) const
 			{ return (this->_node == bst_it._node); }
 
-            bool operator!=(const BST_const_iterator& bst_it)
+            bool operator!=(const BST_const_iterator& bst_it) const
 			{ return (this->_node != bst_it._node); }
 
             reference operator*() const
@@ -610,28 +628,10 @@ namespace ft
 
             BST_const_iterator& operator++(void)
             {
-                T* cursor = _node;
-                if (_node->right == _last_node)
-                {
-                    cursor = _node->parent;
-                    while (cursor != _last_node && _comp(cursor->value.first, _node->value.first))
-                        cursor = cursor->parent;
-                    _node = cursor;
-                }
-                else if (cursor == _last_node)
+                if (_node == _last_node)
                     _node = _last_node->right;
                 else
-                {
-                    cursor = _node->right;
-                    if (cursor == _last_node->parent && cursor->right == _last_node)
-                        _node = cursor;
-                    else
-                    {
-                        while (cursor->left != _last_node)
-                            cursor = cursor->left;
-                    }
-                    _node = cursor;
-                }
+                    _node = ft::tree_next(_node, _last_node);
                 return (*this);
             }
 
@@ -644,29 +644,10 @@ namespace ft
 
             BST_const_iterator& operator--(void)
             {
-                T* cursor = _node;
-
-                if (_node->left == _last_node)
-                {
-                    cursor = _node->parent;
-                    while (cursor != _last_node && !_comp(cursor->value.first, _node->value.first))
-                        cursor = cursor->parent;
-                    _node = cursor;
-                }
-                else if (cursor == _last_node)
+                if (_node == _last_node)
                     _node = _last_node->right;
                 else
-                {
-                    cursor = _node->left;
-                    if (cursor == _last_node->parent && cursor->left == _last_node)
-                        _node = cursor;
-                    else
-                    {
-                        while (cursor->right != _last_node)
-                            cursor = cursor->right;
-                    }
-                    _node = cursor;
-                }
+                    _node = ft::tree_prev(_node, _last_node);
                 return (*this);
             }
 
@@ -680,7 +661,6 @@ namespace ft
         private :
             T* _node;
             T* _last_node;
-            Compare _comp;
     };
 
 }
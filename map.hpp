@@ -1,314 +1,129 @@
 #ifndef MAP_HPP
 #define MAP_HPP
 
-#include "utils.hpp"
-#include "iterators.hpp"
-#include "binarySearchTree.hpp"
-#include "pair.hpp"
-#include <memory>
-#include <functional>
-#include <iostream>
+#include "treeContainer.hpp"
+#include <stdexcept>
+#include <utility>
 
 namespace ft
 {
+	/*
+	** Values are (key, mapped value) pairs, each key is held once.
+	** Everything but element access lives in ft::tree_container.
+	** extract(), insert(node_handle_type&&), merge(), split() and join()
+	** only move nodes without copying between maps built on one node pool
+	** (map(other.get_node_allocator())); across pools every value is copied
+	** into a new node. The pool is not thread safe: maps sharing one must
+	** be used from a single thread, or under a lock of their own.
+	*/
 		template < class Key, class T, class Compare = std::less<Key>,
-				class Alloc = std::allocator<ft::pair<const Key, T> > >
-	class map
+				class Alloc = std::allocator<ft::pair<const Key, T> >,
+				class Balance = ft::red_black_balance,
+				class Augment = ft::no_order_statistics >
+	class map : public ft::tree_container< map<Key, T, Compare, Alloc, Balance, Augment>,
+		ft::pair<Key, T>, ft::select_first< ft::pair<Key, T> >, ft::unique_keys,
+		Compare, Alloc, Balance, Augment >
 	{
-		public:
+		typedef ft::tree_container< map, ft::pair<Key, T>, ft::select_first< ft::pair<Key, T> >,
+			ft::unique_keys, Compare, Alloc, Balance, Augment > base;
 
-			typedef Key     key_type;
+		public:
 
 			typedef T       mapped_type;
 
-			typedef ft::pair<key_type, mapped_type> value_type;
-
-			typedef Compare     key_compare;
-
-			class value_compare : std::binary_function<value_type, value_type, bool>
-			{
-				friend class map<key_type, mapped_type, key_compare, Alloc>;
-				
-				protected:
-					Compare comp;
-					value_compare (Compare c) : comp(c) {}
-				
-				public:
-
-					bool operator() (const value_type& x, const value_type& y) const
-					{ return (comp(x.first, y.first)); }
-			};
-
-			typedef Alloc  allocator_type;
-
-			typedef typename allocator_type::reference   reference;
-
-			typedef typename allocator_type::const_reference const_reference;
-
-			typedef typename allocator_type::pointer     pointer;
-
-			typedef typename allocator_type::const_pointer const_pointer;
-
-			typedef typename ft::BST<value_type, key_compare>::iterator iterator;
-
-			typedef typename ft::BST<value_type, key_compare>::const_iterator const_iterator;
-
-			typedef typename ft::reverse_iterator<iterator>    reverse_iterator;
-
-			typedef typename ft::reverse_iterator<const_iterator> const_reverse_iterator;
-
-			typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
-
-			typedef size_t size_type;
-
-
-			// Constructors
-
-			explicit map (const key_compare& comp = key_compare(),
-				const allocator_type& alloc = allocator_type())
-			:
-				_alloc(alloc),
-				_comp(comp),
-				_bst()
-			{}
-
-
-			template <class InputIterator>
-				map (InputIterator first, InputIterator last,
-					const key_compare& comp = key_compare(),
-					const allocator_type& alloc = allocator_type(),
-					typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
-			:	
-				_alloc(alloc),
-				_comp(comp),
-				_bst()
-			{
-				bool is_valid;
-				if (!(is_valid = ft::is_input_iterator_tagged<typename ft::iterator_traits<InputIterator>::iterator_category >::value))
-					return;
-				this->insert(first, last);
-			}
-			
-
-			map(const map& x)
-			:
-				_alloc(x._alloc),
-				_comp(x._comp),
-				_bst()
-			{
-				this->insert(x.begin(), x.end());
-			}
-
-
-			// Destructor
-
-			~map()
-			{ this->clear(); }
-
-			
-			// Operator=
-
-			map& operator= (const map& x)
-			{
-				if (&x == this)
-					return (*this);
-				this->clear();
-				this->insert(x.begin(), x.end());
-				return (*this);
-			}
-
-			
-			// Iterators
-
-			iterator begin()
-			{ return (iterator(_bst._last_node->left, _bst._last_node)); }
-
-			const_iterator begin() const
-			{ return (const_iterator(_bst._last_node->left, _bst._last_node)); }
-
-
-			iterator end()
-			{ return (iterator(_bst._last_node, _bst._last_node)); }
-
-			const_iterator end() const
-			{ return (const_iterator(_bst._last_node, _bst._last_node)); }
-
-
-			reverse_iterator rbegin()
-			{ return (reverse_iterator(this->end())); }
-
-			const_reverse_iterator rbegin() const
-			{ return (const_reverse_iterator(this->end())); }
-
-
-			reverse_iterator rend()
-			{ return (reverse_iterator(this->begin())); }
+			typedef typename base::key_type     key_type;
 
-			const_reverse_iterator rend() const
-			{ return (const_reverse_iterator(this->begin())); }
+			typedef typename base::iterator     iterator;
 
-			
-			// Capacity
+			typedef typename base::tree_type    tree_type;
 
-			bool empty() const
-			{ return (_bst._last_node->parent == _bst._last_node); }
+			using base::base;
 
-			
-			size_type size() const
-			{ return (_bst._last_node->value.first); }
 
-
-			size_type max_size() const
-			{ return (_bst.max_size()); }
-
-		
 			// Element access
 
+			// One descent, a node is only allocated when k is missing
 			mapped_type& operator[] (const key_type& k)
-			{
-				iterator tmp = this->find(k);
-
-				if (tmp == this->end())
-					this->insert(ft::make_pair(k, mapped_type()));
-				tmp = this->find(k);
-				return ((*tmp).second);
-			} 
-
-			
-			// Modifiers
-
-			pair<iterator,bool> insert (const value_type& val)
-			{ return (_bst.insertPair(val)); }
-
-			iterator insert (iterator position, const value_type& val)
-			{
-				(void)position;
-				return (_bst.insertPair(val).first);
-			}
-
-			template <class InputIterator>
-				void insert (InputIterator first, InputIterator last,
-				typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
-			{
-				bool is_valid;
-				if (!(is_valid = ft::is_input_iterator_tagged<typename ft::iterator_traits<InputIterator>::iterator_category >::value))
-					return;
-				difference_type n = ft::distnce(first, last);
-				while (n--)
-					this->insert(*(first++));
-			}
-
-			
-			void erase (iterator position)
-			{ this->erase((*position).first); }
-
-			size_type erase (const key_type& k)
-			{
-				if (this->find(k) == this->end())
-					return (0);
-				_bst.removeByKey(ft::make_pair(k, mapped_type()));
-				return (1);
-			}
-
-			void erase (iterator first, iterator last)
-			{
-				while (first != last)
-					this->erase((*(first++)).first);
-			}
-
-
-			void swap (map& x)
-			{ _bst.swap(x._bst); }
-
+			{ return (this->try_emplace(k).first->second); }
 
-			void clear()
-			{ this->erase(this->begin(), this->end()); }
+			mapped_type& at (const key_type& k)
+			{ return (_at(k)); }
 
-			
-			// Observers
+			const mapped_type& at (const key_type& k) const
+			{ return (_at(k)); }
 
-			key_compare key_comp() const
-			{ return (key_compare()); }
-
-
-			value_compare value_comp() const
-			{ return (value_compare(key_compare())); }
-
-
-			// Operations
-
-			iterator find (const key_type& k)
-			{ return (iterator(_bst.searchByKey(ft::make_pair(k, mapped_type())), _bst._last_node)); }
-
-			const_iterator find (const key_type& k) const
-			{ return (const_iterator(_bst.searchByKey(ft::make_pair(k, mapped_type())), _bst._last_node)); }
 
+			// Modifiers
 
-			size_type count (const key_type& k) const
+			// Inserts k with a mapped value built in place from args, unless k
+			// is already there: then nothing is built and args are left alone
+			template <class... Args>
+				ft::pair<iterator, bool> try_emplace (const key_type& k, Args&&... args)
 			{
-				const_iterator beg = this->begin();
-				const_iterator end = this->end();
-
-				while (beg != end)
-					if ((*(beg++)).first == k)
-						return (1);
-				return (0);
+				typename tree_type::node_pointer parent;
+				bool side;
+				typename tree_type::node_pointer node = this->_bst.findSlot(k, parent, side);
+
+				if (node != nullptr)
+					return (ft::make_pair(iterator(node, this->_bst._last_node), false));
+				return (ft::make_pair(this->_bst.emplaceAt(parent, side,
+					ft::in_place_t(), k, std::forward<Args>(args)...), true));
 			}
 
-
-			iterator lower_bound (const key_type& k)
+			// Inserts (k, obj), or assigns obj to the value of k when it is there
+			template <class M>
+				ft::pair<iterator, bool> insert_or_assign (const key_type& k, M&& obj)
 			{
-				iterator beg = this->begin();
-				iterator end = this->end();
+				typename tree_type::node_pointer parent;
+				bool side;
+				typename tree_type::node_pointer node = this->_bst.findSlot(k, parent, side);
 
-				while (beg != end)
+				if (node != nullptr)
 				{
-					if (_comp((*beg).first, k) == false)
-						break;
-					beg++;
+					node->value.second = std::forward<M>(obj);
+					return (ft::make_pair(iterator(node, this->_bst._last_node), false));
 				}
-				return (beg);
+				return (ft::make_pair(this->_bst.emplaceAt(parent, side,
+					ft::in_place_t(), k, std::forward<M>(obj)), true));
 			}
 
-			const_iterator lower_bound (const key_type& k) const
-			{ return (const_iterator(this->lower_bound(k))); }
-
+		private:
 
-			iterator upper_bound (const key_type& k)
+			mapped_type& _at(const key_type& k) const
 			{
-				iterator beg = this->begin();
-				iterator end = this->end();
+				typename tree_type::node_pointer node = this->_bst.searchByKey(k);
 
-				while (beg != end)
-				{
-					if (_comp(k, (*beg).first))
-						break;
-					beg++;
-				}
-				return (beg);
+				if (node == this->_bst._last_node)
+					throw std::out_of_range("ft::map::at");
+				return (node->value.second);
 			}
 
-			const_iterator upper_bound (const key_type& k) const
-			{ return (const_iterator(this->upper_bound(k))); }
-
-
-			ft::pair<const_iterator, const_iterator> equal_range (const key_type& k) const
-			{ return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+	};
 
-			ft::pair<iterator, iterator> equal_range (const key_type& k)
-			{ return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+	/*
+	** ft::map allowing equal keys: the same tree with ft::equal_keys, a value
+	** goes after those with an equal key in one descent, and erase(key)
+	** removes the whole equal range
+	*/
+		template < class Key, class T, class Compare = std::less<Key>,
+				class Alloc = std::allocator<ft::pair<const Key, T> >,
+				class Balance = ft::red_black_balance,
+				class Augment = ft::no_order_statistics >
+	class multimap : public ft::tree_container< multimap<Key, T, Compare, Alloc, Balance, Augment>,
+		ft::pair<Key, T>, ft::select_first< ft::pair<Key, T> >, ft::equal_keys,
+		Compare, Alloc, Balance, Augment >
+	{
+		typedef ft::tree_container< multimap, ft::pair<Key, T>, ft::select_first< ft::pair<Key, T> >,
+			ft::equal_keys, Compare, Alloc, Balance, Augment > base;
 
-			// Allocator:
-			allocator_type get_allocator() const { return _alloc; }
+		public:
 
-		private:
+			typedef T       mapped_type;
 
-			allocator_type                          _alloc;
-			Compare                                 _comp;
-			BST<value_type, Compare>  				_bst;
+			using base::base;
 
 	};
-           
+
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,134 @@
+#ifndef NODEHANDLE_HPP
+#define NODEHANDLE_HPP
+
+#include <new>
+
+namespace ft
+{
+	/*
+	** Owning handle on a node taken out of a tree (map::extract()).
+	** The value can be changed, key included, and the node linked back into
+	** a tree built on the same pool without allocating or copying it.
+	** A handle keeps a copy of the pool, so a node outliving its container
+	** is still freed correctly; an empty handle holds no pool at all.
+	** Handles move, they do not copy.
+	*/
+	template < class Node, class NodeAlloc, class KeyOf >
+	class node_handle
+	{
+		public:
+
+			typedef typename Node::value_type   value_type;
+
+			typedef typename KeyOf::key_type    key_type;
+
+			typedef NodeAlloc                   allocator_type;
+
+			node_handle()
+			:
+				_node(nullptr)
+			{}
+
+			node_handle(Node* node, const allocator_type& alloc)
+			:
+				_node(node)
+			{ new (_alloc_storage) allocator_type(alloc); }
+
+			node_handle(node_handle&& x)
+			:
+				_node(nullptr)
+			{ _take(x); }
+
+			~node_handle()
+			{ _free(); }
+
+			node_handle& operator= (node_handle&& x)
+			{
+				if (&x == this)
+					return (*this);
+				_free();
+				_take(x);
+				return (*this);
+			}
+
+			bool empty() const
+			{ return (_node == nullptr); }
+
+			explicit operator bool() const
+			{ return (_node != nullptr); }
+
+			value_type& value() const
+			{ return (_node->value); }
+
+			// Writable: a node can be re-keyed before being inserted again
+			key_type& key() const
+			{ return (const_cast<key_type&>(KeyOf::key(_node->value))); }
+
+			// Maps only
+			template < class V = value_type >
+			typename V::second_type& mapped() const
+			{ return (_node->value.second); }
+
+			allocator_type get_allocator() const
+			{ return (_alloc()); }
+
+			void swap(node_handle& x)
+			{
+				node_handle save(static_cast<node_handle&&>(x));
+				x = static_cast<node_handle&&>(*this);
+				*this = static_cast<node_handle&&>(save);
+			}
+
+			// Container side: the node, still owned by the handle
+			Node* node() const
+			{ return (_node); }
+
+			// Container side: the node has been linked, the handle lets it go
+			void release()
+			{
+				_alloc().~allocator_type();
+				_node = nullptr;
+			}
+
+		private:
+
+			node_handle(const node_handle&);
+			node_handle& operator= (const node_handle&);
+
+			allocator_type& _alloc() const
+			{ return (*reinterpret_cast<allocator_type*>(const_cast<unsigned char*>(_alloc_storage))); }
+
+			void _take(node_handle& x)
+			{
+				if (x._node == nullptr)
+					return ;
+				new (_alloc_storage) allocator_type(x._alloc());
+				_node = x._node;
+				x.release();
+			}
+
+			void _free()
+			{
+				if (_node == nullptr)
+					return ;
+				_alloc().destroy(_node);
+				_alloc().deallocate(_node, 1);
+				release();
+			}
+
+			Node*   _node;
+			alignas(allocator_type) unsigned char _alloc_storage[sizeof(allocator_type)];
+	};
+
+	// What inserting a node handle gives back: where the key is, and the
+	// handle itself when the node could not be inserted
+	template < class Iterator, class NodeHandle >
+	struct node_insert_return
+	{
+		Iterator    position;
+		bool        inserted;
+		NodeHandle  node;
+	};
+}
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef NODEPOOL_HPP
+#define NODEPOOL_HPP
+
+#include <memory>
+#include <new>
+#include <cstddef>
+
+namespace ft
+{
+	/*
+	** Slab allocator for fixed size objects (tree nodes).
+	** Single object requests are served from slabs obtained from Alloc, each
+	** twice as big as the previous one; freed objects go to a free list and
+	** are handed back first, so an allocate/deallocate pair is a pointer pop
+	** and push. Slabs are only returned to Alloc when the pool goes away.
+	**
+	** Copies of a node_pool share the same slabs and compare equal, so any of
+	** them can free what another allocated: containers built on one pool can
+	** hand nodes to each other. It does no locking, so all of them must stay
+	** on one thread.
+	*/
+	template < class T, class Alloc = std::allocator<T> >
+	class node_pool
+	{
+		public :
+
+			typedef T                   value_type;
+			typedef T*                  pointer;
+			typedef const T*            const_pointer;
+			typedef T&                  reference;
+			typedef const T&            const_reference;
+			typedef size_t              size_type;
+			typedef ptrdiff_t           difference_type;
+
+			typedef Alloc               upstream_type;
+
+			template < class U >
+			struct rebind
+			{ typedef node_pool<U, typename Alloc::template rebind<U>::other> other; };
+
+			explicit node_pool(const upstream_type& upstream = upstream_type())
+			:
+				_state(_newState(upstream))
+			{}
+
+			node_pool(const node_pool& x)
+			:
+				_state(x._state)
+			{ _state->refs += 1; }
+
+			// Pools of another type never share slabs
+			template < class U, class A >
+			node_pool(const node_pool<U, A>& x)
+			:
+				_state(_newState(upstream_type(x.upstream())))
+			{}
+
+			~node_pool()
+			{ _release(); }
+
+			node_pool& operator=(const node_pool& x)
+			{
+				if (x._state == _state)
+					return (*this);
+				x._state->refs += 1;
+				_release();
+				_state = x._state;
+				return (*this);
+			}
+
+			pointer allocate(size_type n, const void* = nullptr)
+			{
+				if (n != 1)
+					return (_state->upstream.allocate(n));
+				if (_state->free_list != nullptr)
+				{
+					free_block* block = _state->free_list;
+					_state->free_list = block->next;
+					_state->free_count -= 1;
+					return (reinterpret_cast<pointer>(block));
+				}
+				if (_state->cursor == _state->cursor_end)
+					_grow(_state->next_slab);
+				return (_state->cursor++);
+			}
+
+			void deallocate(pointer p, size_type n)
+			{
+				if (n != 1)
+				{
+					_state->upstream.deallocate(p, n);
+					return ;
+				}
+				free_block* block = reinterpret_cast<free_block*>(p);
+				block->next = _state->free_list;
+				_state->free_list = block;
+				_state->free_count += 1;
+			}
+
+			void construct(pointer p, const_reference val)
+			{ new (static_cast<void*>(p)) value_type(val); }
+
+			void destroy(pointer p)
+			{ p->~value_type(); }
+
+			size_type max_size() const
+			{ return (_state->upstream.max_size()); }
+
+			// Makes sure the next n single allocations need no new slab
+			void reserve(size_type n)
+			{
+				size_type available = _state->free_count + (_state->cursor_end - _state->cursor);
+
+				if (available < n)
+					_grow(n - available);
+			}
+
+			upstream_type upstream() const
+			{ return (_state->upstream); }
+
+			bool operator==(const node_pool& x) const
+			{ return (_state == x._state); }
+
+			bool operator!=(const node_pool& x) const
+			{ return (_state != x._state); }
+
+		private :
+
+			struct free_block
+			{ free_block* next; };
+
+			struct slab
+			{
+				pointer     blocks;
+				size_type   count;
+				slab*       next;
+			};
+
+			typedef typename Alloc::template rebind<slab>::other slab_alloc;
+
+			struct pool_state
+			{
+				size_type       refs;
+				free_block*     free_list;
+				size_type       free_count;
+				pointer         cursor;
+				pointer         cursor_end;
+				slab*           slabs;
+				size_type       next_slab;
+				upstream_type   upstream;
+
+				pool_state(const upstream_type& alloc)
+				:
+					refs(1), free_list(nullptr), free_count(0), cursor(nullptr),
+					cursor_end(nullptr), slabs(nullptr), next_slab(8), upstream(alloc)
+				{}
+			};
+
+			typedef typename Alloc::template rebind<pool_state>::other state_alloc;
+
+			static pool_state* _newState(const upstream_type& upstream)
+			{
+				state_alloc alloc(upstream);
+				pool_state* state = alloc.allocate(1);
+				alloc.construct(state, pool_state(upstream));
+				return (state);
+			}
+
+			// Opens a slab of at least count blocks as the new bump region; the
+			// rest of the previous region is moved to the free list
+			void _grow(size_type count)
+			{
+				if (count < _state->next_slab)
+					count = _state->next_slab;
+				while (_state->cursor != _state->cursor_end)
+					deallocate(_state->cursor++, 1);
+
+				slab_alloc alloc(_state->upstream);
+				slab* new_slab = alloc.allocate(1);
+				new_slab->blocks = _state->upstream.allocate(count);
+				new_slab->count = count;
+				new_slab->next = _state->slabs;
+				_state->slabs = new_slab;
+
+				_state->cursor = new_slab->blocks;
+				_state->cursor_end = new_slab->blocks + count;
+				_state->next_slab = count * 2;
+			}
+
+			void _release()
+			{
+				_state->refs -= 1;
+				if (_state->refs != 0)
+					return ;
+
+				slab_alloc alloc(_state->upstream);
+				while (_state->slabs != nullptr)
+				{
+					slab* next = _state->slabs->next;
+					_state->upstream.deallocate(_state->slabs->blocks, _state->slabs->count);
+					alloc.deallocate(_state->slabs, 1);
+					_state->slabs = next;
+				}
+				state_alloc state(_state->upstream);
+				state.destroy(_state);
+				state.deallocate(_state, 1);
+			}
+
+			pool_state* _state;
+
+			template < class U, class A >
+			friend class node_pool;
+	};
+}
+
+#endif
@@ -1,8 +1,14 @@
 #ifndef PAIR_HPP
 #define PAIR_HPP
 
+#include <utility>
+
 namespace ft
 {
+	// Tag for the constructors building a member in place from the
+	// arguments that follow it
+	struct in_place_t {};
+
 	template < class T1, class T2 >
 	struct pair
 	{
@@ -15,12 +21,18 @@ namespace ft
 		second_type second;
 
 		pair() : first(), second() {}
+
+		pair (const pair& pr) : first(pr.first), second(pr.second) {}
 		
 		template<class U, class V> 
 		pair (const pair< U, V >& pr) : first(pr.first), second(pr.second) {}
 
 		pair (const first_type& a, const second_type& b) : first(a), second(b) {}
 
+		// second built from args, for map::try_emplace()
+		template<class... Args>
+		pair (ft::in_place_t, const first_type& a, Args&&... args) : first(a), second(std::forward<Args>(args)...) {}
+
 
 		pair& operator= (const pair& pr)
 		{
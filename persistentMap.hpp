@@ -0,0 +1,705 @@
+#ifndef PERSISTENTMAP_HPP
+#define PERSISTENTMAP_HPP
+
+#include "utils.hpp"
+#include "iterators.hpp"
+#include "pair.hpp"
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <functional>
+
+namespace ft
+{
+	/*
+	** Node shared between the versions of a persistent_map: refs counts the
+	** maps and nodes pointing to it. No parent link, so one node can sit in
+	** many trees; it is only changed in place by a writer holding the only
+	** reference to it, otherwise it is copied. height is the AVL height.
+	*/
+	template < class Value >
+	struct persistent_node
+	{
+		typedef Value value_type;
+
+		value_type              value;
+		persistent_node*        left;
+		persistent_node*        right;
+		std::atomic<size_t>     refs;
+		int                     height;
+
+		persistent_node(const value_type& val, persistent_node* left, persistent_node* right)
+		:
+			value(val), left(left), right(right), refs(1), height(1)
+		{}
+	};
+
+	/*
+	** Without parent links the iterator keeps the path from the root to its
+	** node; end() is the empty path. An AVL tree of height 64 would need more
+	** than 10^13 nodes, so the path never overflows.
+	*/
+	template < class Node >
+	class persistent_iterator : ft::iterator< ft::bidirectional_iterator_tag, typename Node::value_type >
+	{
+		public :
+			typedef typename Node::value_type value_type;
+			typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::iterator_category iterator_category;
+			typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::difference_type   difference_type;
+			typedef const value_type*   pointer;
+			typedef const value_type&   reference;
+
+			static const int max_height = 64;
+
+			persistent_iterator() : _root(nullptr), _depth(0) {}
+
+			// begin() when first is set, else end()
+			persistent_iterator(const Node* root, bool first) : _root(root), _depth(0)
+			{
+				if (first)
+					_pushLeftmost(root);
+			}
+
+			// First value whose key is not less than key (greater with upper)
+			template < class Key, class Compare >
+			persistent_iterator(const Node* root, const Key& key, const Compare& comp, bool upper)
+			:
+				_root(root),
+				_depth(0)
+			{
+				int found = 0;
+
+				for (const Node* node = root; node != nullptr; )
+				{
+					_path[_depth++] = node;
+					if (upper ? comp(key, node->value.first) : !comp(node->value.first, key))
+					{
+						found = _depth;
+						node = node->left;
+					}
+					else
+						node = node->right;
+				}
+				_depth = found;
+			}
+
+			persistent_iterator(const persistent_iterator& it) : _root(it._root), _depth(it._depth)
+			{
+				for (int i = 0; i < _depth; ++i)
+					_path[i] = it._path[i];
+			}
+
+			~persistent_iterator() {}
+
+			persistent_iterator &operator=(const persistent_iterator& it)
+			{
+				_root = it._root;
+				_depth = it._depth;
+				for (int i = 0; i < _depth; ++i)
+					_path[i] = it._path[i];
+				return (*this);
+			}
+
+			// Node at the iterator, nullptr for end()
+			const Node* base() const
+			{ return (_depth == 0 ? nullptr : _path[_depth - 1]); }
+
+			bool operator==(const persistent_iterator& it) const
+			{ return (base() == it.base()); }
+
+			bool operator!=(const persistent_iterator& it) const
+			{ return (base() != it.base()); }
+
+			reference operator*() const
+			{ return (_path[_depth - 1]->value); }
+
+			pointer operator->() const
+			{ return (&_path[_depth - 1]->value); }
+
+			persistent_iterator& operator++()
+			{
+				const Node* node = _path[_depth - 1];
+
+				if (node->right != nullptr)
+				{
+					_pushLeftmost(node->right);
+					return (*this);
+				}
+				// up to the first ancestor reached from its left
+				while (--_depth > 0 && _path[_depth - 1]->right == node)
+					node = _path[_depth - 1];
+				return (*this);
+			}
+
+			persistent_iterator operator++(int)
+			{
+				persistent_iterator tmp(*this);
+				operator++();
+				return (tmp);
+			}
+
+			persistent_iterator& operator--()
+			{
+				if (_depth == 0)
+				{
+					_pushRightmost(_root);
+					return (*this);
+				}
+
+				const Node* node = _path[_depth - 1];
+
+				if (node->left != nullptr)
+				{
+					_pushRightmost(node->left);
+					return (*this);
+				}
+				while (--_depth > 0 && _path[_depth - 1]->left == node)
+					node = _path[_depth - 1];
+				return (*this);
+			}
+
+			persistent_iterator operator--(int)
+			{
+				persistent_iterator tmp(*this);
+				operator--();
+				return (tmp);
+			}
+
+		private :
+
+			void _pushLeftmost(const Node* node)
+			{
+				for (; node != nullptr; node = node->left)
+					_path[_depth++] = node;
+			}
+
+			void _pushRightmost(const Node* node)
+			{
+				for (; node != nullptr; node = node->right)
+					_path[_depth++] = node;
+			}
+
+			const Node*     _root;
+			int             _depth;
+			const Node*     _path[max_height];
+	};
+
+	/*
+	** Persistent map: copies and snapshot() are O(1) and share the whole
+	** tree, an update copies the O(log n) nodes on its path that are shared
+	** (none when the map has not been copied) and leaves every other version
+	** untouched. A snapshot can be handed to readers on other threads while
+	** the writer keeps updating its own map; each map object, though, has a
+	** single owner. Nodes may be freed by whichever version lets them go
+	** last, so Alloc must allow freeing through any of its copies.
+	** Values are read only through iterators, use insert_or_assign().
+	*/
+		template < class Key, class T, class Compare = std::less<Key>,
+				class Alloc = std::allocator<ft::pair<const Key, T> > >
+	class persistent_map
+	{
+		public:
+
+			typedef Key     key_type;
+
+			typedef T       mapped_type;
+
+			typedef ft::pair<key_type, mapped_type> value_type;
+
+			typedef Compare     key_compare;
+
+			class value_compare : ft::binary_function<value_type, value_type, bool>
+			{
+				friend class persistent_map<key_type, mapped_type, key_compare, Alloc>;
+
+				protected:
+					Compare comp;
+					value_compare (Compare c) : comp(c) {}
+
+				public:
+
+					bool operator() (const value_type& x, const value_type& y) const
+					{ return (comp(x.first, y.first)); }
+			};
+
+			typedef Alloc  allocator_type;
+
+			typedef typename allocator_type::reference   reference;
+
+			typedef typename allocator_type::const_reference const_reference;
+
+			typedef typename allocator_type::pointer     pointer;
+
+			typedef typename allocator_type::const_pointer const_pointer;
+
+			typedef ft::persistent_node<value_type> node_type;
+
+			typedef typename Alloc::template rebind<node_type>::other node_allocator_type;
+
+			typedef ft::persistent_iterator<node_type> iterator;
+
+			typedef ft::persistent_iterator<node_type> const_iterator;
+
+			typedef typename ft::reverse_iterator<iterator>    reverse_iterator;
+
+			typedef typename ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+			typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
+
+			typedef size_t size_type;
+
+
+			// Constructors
+
+			explicit persistent_map (const key_compare& comp = key_compare(),
+				const allocator_type& alloc = allocator_type())
+			:
+				_alloc(alloc),
+				_comp(comp),
+				_root(nullptr),
+				_size(0)
+			{}
+
+
+			template <class InputIterator>
+				persistent_map (InputIterator first, InputIterator last,
+					const key_compare& comp = key_compare(),
+					const allocator_type& alloc = allocator_type(),
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			:
+				_alloc(alloc),
+				_comp(comp),
+				_root(nullptr),
+				_size(0)
+			{ this->insert(first, last); }
+
+
+			// Shares the tree of x, O(1)
+			persistent_map(const persistent_map& x)
+			:
+				_alloc(x._alloc),
+				_comp(x._comp),
+				_root(x._root),
+				_size(x._size)
+			{ _retain(_root); }
+
+
+			// Destructor
+
+			~persistent_map()
+			{ _release(_root); }
+
+
+			// Operator=
+
+			persistent_map& operator= (const persistent_map& x)
+			{
+				if (&x == this)
+					return (*this);
+				_retain(x._root);
+				_release(_root);
+				_root = x._root;
+				_size = x._size;
+				_comp = x._comp;
+				return (*this);
+			}
+
+
+			// Frozen version of the map as it is now, O(1)
+			persistent_map snapshot() const
+			{ return (persistent_map(*this)); }
+
+
+			// Iterators
+
+			const_iterator begin() const
+			{ return (const_iterator(_root, true)); }
+
+			const_iterator end() const
+			{ return (const_iterator(_root, false)); }
+
+			const_reverse_iterator rbegin() const
+			{ return (const_reverse_iterator(this->end())); }
+
+			const_reverse_iterator rend() const
+			{ return (const_reverse_iterator(this->begin())); }
+
+
+			// Capacity
+
+			bool empty() const
+			{ return (_size == 0); }
+
+
+			size_type size() const
+			{ return (_size); }
+
+
+			size_type max_size() const
+			{ return (node_allocator_type(_alloc).max_size()); }
+
+
+			// Modifiers
+
+			// One descent that copies nothing when the key is already there;
+			// the iterator is looked up in the updated tree
+			ft::pair<const_iterator, bool> insert (const value_type& val)
+			{
+				bool found;
+
+				_root = _insert(_root, val, false, true, found);
+				if (!found)
+					_size += 1;
+				return (ft::make_pair(this->find(val.first), !found));
+			}
+
+			template <class InputIterator>
+				void insert (InputIterator first, InputIterator last,
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			{
+				for (; first != last; ++first)
+					this->insert(*first);
+			}
+
+			ft::pair<const_iterator, bool> insert_or_assign (const key_type& k, const mapped_type& obj)
+			{
+				bool found;
+
+				_root = _insert(_root, value_type(k, obj), true, true, found);
+				if (!found)
+					_size += 1;
+				return (ft::make_pair(this->find(k), !found));
+			}
+
+
+			size_type erase (const key_type& k)
+			{
+				bool found;
+
+				_root = _erase(_root, k, true, found);
+				if (!found)
+					return (0);
+				_size -= 1;
+				return (1);
+			}
+
+
+			void swap (persistent_map& x)
+			{
+				node_type* save_root = _root;
+				_root = x._root;
+				x._root = save_root;
+
+				size_type save_size = _size;
+				_size = x._size;
+				x._size = save_size;
+
+				key_compare save_comp = _comp;
+				_comp = x._comp;
+				x._comp = save_comp;
+			}
+
+
+			void clear()
+			{
+				_release(_root);
+				_root = nullptr;
+				_size = 0;
+			}
+
+
+			// Observers
+
+			key_compare key_comp() const
+			{ return (_comp); }
+
+
+			value_compare value_comp() const
+			{ return (value_compare(_comp)); }
+
+
+			// Operations
+
+			const_iterator find (const key_type& k) const
+			{
+				const_iterator it = this->lower_bound(k);
+
+				if (it != this->end() && _comp(k, it->first))
+					return (this->end());
+				return (it);
+			}
+
+
+			size_type count (const key_type& k) const
+			{ return (this->find(k) != this->end()); }
+
+
+			const_iterator lower_bound (const key_type& k) const
+			{ return (const_iterator(_root, k, _comp, false)); }
+
+
+			const_iterator upper_bound (const key_type& k) const
+			{ return (const_iterator(_root, k, _comp, true)); }
+
+
+			ft::pair<const_iterator, const_iterator> equal_range (const key_type& k) const
+			{ return (ft::make_pair(this->lower_bound(k), this->upper_bound(k))); }
+
+			// Allocator:
+			allocator_type get_allocator() const { return _alloc; }
+
+		private:
+
+			typedef node_type* node_pointer;
+
+			allocator_type                          _alloc;
+			Compare                                 _comp;
+			node_pointer                            _root;
+			size_type                               _size;
+
+			static int _height(node_pointer node)
+			{ return (node == nullptr ? 0 : node->height); }
+
+			static void _update(node_pointer node)
+			{
+				int left = _height(node->left);
+				int right = _height(node->right);
+				node->height = 1 + (left > right ? left : right);
+			}
+
+			static void _retain(node_pointer node)
+			{
+				if (node != nullptr)
+					node->refs.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			// Drops a reference, freeing what nothing points to anymore
+			void _release(node_pointer node) const
+			{
+				while (node != nullptr && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					node_pointer left = node->left;
+					node_pointer right = node->right;
+					node_allocator_type alloc(_alloc);
+
+					node->~node_type();
+					alloc.deallocate(node, 1);
+					_release(left);
+					node = right;
+				}
+			}
+
+			// Takes over the references to left and right
+			node_pointer _newNode(const value_type& val, node_pointer left, node_pointer right) const
+			{
+				node_allocator_type alloc(_alloc);
+				node_pointer node = alloc.allocate(1);
+
+				new (static_cast<void*>(node)) node_type(val, left, right);
+				_update(node);
+				return (node);
+			}
+
+			/*
+			** Path copying: the functions below take over the caller's
+			** reference to node and hand back one to the updated subtree.
+			** A node whose only reference is the caller's is reachable from
+			** no other version, so it is changed in place; any other is
+			** copied first.
+			*/
+
+			node_pointer _own(node_pointer node) const
+			{
+				if (node->refs.load(std::memory_order_acquire) == 1)
+					return (node);
+				return (_copy(node, true));
+			}
+
+			// The copy shares both children of node; it takes over the
+			// parent's reference when the parent is changed in place
+			// (exclusive), else the old parent keeps pointing to node
+			node_pointer _copy(node_pointer node, bool exclusive) const
+			{
+				_retain(node->left);
+				_retain(node->right);
+				node_pointer copy = _newNode(node->value, node->left, node->right);
+				if (exclusive)
+					_release(node);
+				return (copy);
+			}
+
+			node_pointer _rotateLeft(node_pointer node) const
+			{
+				node_pointer right = _own(node->right);
+
+				node->right = right->left;
+				right->left = node;
+				_update(node);
+				_update(right);
+				return (right);
+			}
+
+			node_pointer _rotateRight(node_pointer node) const
+			{
+				node_pointer left = _own(node->left);
+
+				node->left = left->right;
+				left->right = node;
+				_update(node);
+				_update(left);
+				return (left);
+			}
+
+			// node is owned, its subtrees differ by two levels at most
+			node_pointer _balance(node_pointer node) const
+			{
+				int balance = _height(node->right) - _height(node->left);
+
+				if (balance > 1)
+				{
+					if (_height(node->right->left) > _height(node->right->right))
+						node->right = _rotateRight(_own(node->right));
+					return (_rotateLeft(node));
+				}
+				if (balance < -1)
+				{
+					if (_height(node->left->right) > _height(node->left->left))
+						node->left = _rotateLeft(_own(node->left));
+					return (_rotateRight(node));
+				}
+				_update(node);
+				return (node);
+			}
+
+			/*
+			** Insert and erase descend without touching the tree and copy
+			** on the way back up, once they know it changes: a key that is
+			** already there (or missing, for erase) costs no copy. exclusive
+			** tells that the parent is changed in place, so that node may be
+			** too when nothing else points to it. Unchanged, node is handed
+			** back as it is.
+			*/
+
+			// Inserts val, or assigns its mapped value when the key is there
+			// and assign is set; found tells whether it was
+			node_pointer _insert(node_pointer node, const value_type& val, bool assign,
+				bool exclusive, bool& found) const
+			{
+				if (node == nullptr)
+				{
+					found = false;
+					return (_newNode(val, nullptr, nullptr));
+				}
+
+				bool mine = exclusive && node->refs.load(std::memory_order_acquire) == 1;
+
+				if (_comp(val.first, node->value.first))
+				{
+					node_pointer left = _insert(node->left, val, assign, mine, found);
+					if (found && !assign)
+						return (node);
+					node = _change(node, mine, exclusive, true, left);
+				}
+				else if (_comp(node->value.first, val.first))
+				{
+					node_pointer right = _insert(node->right, val, assign, mine, found);
+					if (found && !assign)
+						return (node);
+					node = _change(node, mine, exclusive, false, right);
+				}
+				else
+				{
+					found = true;
+					if (!assign)
+						return (node);
+					node = mine ? node : _copy(node, exclusive);
+					node->value.second = val.second;
+					return (node);
+				}
+				return (_balance(node));
+			}
+
+			// Erases k from the subtree, found tells whether it was there
+			node_pointer _erase(node_pointer node, const key_type& k, bool exclusive, bool& found) const
+			{
+				if (node == nullptr)
+				{
+					found = false;
+					return (nullptr);
+				}
+
+				bool mine = exclusive && node->refs.load(std::memory_order_acquire) == 1;
+
+				if (_comp(k, node->value.first))
+				{
+					node_pointer left = _erase(node->left, k, mine, found);
+					if (!found)
+						return (node);
+					node = _change(node, mine, exclusive, true, left);
+				}
+				else if (_comp(node->value.first, k))
+				{
+					node_pointer right = _erase(node->right, k, mine, found);
+					if (!found)
+						return (node);
+					node = _change(node, mine, exclusive, false, right);
+				}
+				else if (node->left == nullptr || node->right == nullptr)
+				{
+					node_pointer child = (node->left != nullptr) ? node->left : node->right;
+
+					// the parent's reference moves from node to child
+					found = true;
+					_retain(child);
+					if (exclusive)
+						_release(node);
+					return (child);
+				}
+				else
+				{
+					found = true;
+					node = mine ? node : _copy(node, exclusive);
+					node->right = _eraseMin(node->right, node->value);
+				}
+				return (_balance(node));
+			}
+
+			// node, changed in place when mine or copied, with its left (or
+			// right) child replaced by the updated subtree
+			node_pointer _change(node_pointer node, bool mine, bool exclusive, bool left, node_pointer child) const
+			{
+				if (!mine)
+				{
+					node = _copy(node, exclusive);
+					// the old node keeps the old child, not the copy
+					_release(left ? node->left : node->right);
+				}
+				if (left)
+					node->left = child;
+				else
+					node->right = child;
+				return (node);
+			}
+
+			// Moves the smallest value of the subtree into min
+			node_pointer _eraseMin(node_pointer node, value_type& min) const
+			{
+				node = _own(node);
+				if (node->left == nullptr)
+				{
+					node_pointer right = node->right;
+
+					min = node->value;
+					node->right = nullptr;
+					_release(node);
+					return (right);
+				}
+				node->left = _eraseMin(node->left, min);
+				return (_balance(node));
+			}
+	};
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SET_HPP
+#define SET_HPP
+
+#include "treeContainer.hpp"
+
+namespace ft
+{
+	/*
+	** The ft::map tree holding bare keys (ft::identity as key extractor).
+	** Keys are never modified in place, so iterator is a const_iterator.
+	*/
+		template < class Key, class Compare = std::less<Key>,
+				class Alloc = std::allocator<Key>,
+				class Balance = ft::red_black_balance,
+				class Augment = ft::no_order_statistics >
+	class set : public ft::tree_container< set<Key, Compare, Alloc, Balance, Augment>,
+		Key, ft::identity<Key>, ft::unique_keys, Compare, Alloc, Balance, Augment >
+	{
+		typedef ft::tree_container< set, Key, ft::identity<Key>, ft::unique_keys,
+			Compare, Alloc, Balance, Augment > base;
+
+		public:
+
+			typedef Compare     value_compare;
+
+			using base::base;
+
+			value_compare value_comp() const
+			{ return (this->_comp); }
+
+	};
+
+	/*
+	** ft::set allowing equal keys (ft::equal_keys): an insert goes after the
+	** keys equal to it in one descent, erase(key) removes them all
+	*/
+		template < class Key, class Compare = std::less<Key>,
+				class Alloc = std::allocator<Key>,
+				class Balance = ft::red_black_balance,
+				class Augment = ft::no_order_statistics >
+	class multiset : public ft::tree_container< multiset<Key, Compare, Alloc, Balance, Augment>,
+		Key, ft::identity<Key>, ft::equal_keys, Compare, Alloc, Balance, Augment >
+	{
+		typedef ft::tree_container< multiset, Key, ft::identity<Key>, ft::equal_keys,
+			Compare, Alloc, Balance, Augment > base;
+
+		public:
+
+			typedef Compare     value_compare;
+
+			using base::base;
+
+			value_compare value_comp() const
+			{ return (this->_comp); }
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,224 @@
+#include "./../map.hpp"
+#include "./../btreeMap.hpp"
+#include "./../flatMap.hpp"
+#include "./../unorderedMap.hpp"
+#include "./../concurrentMap.hpp"
+#include <chrono>
+#include <ctime>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+** Times the same workload on every container, in milliseconds.
+** Usage: ./benchmark [element count]
+** Containers that shift values on update only run the bulk build and
+** the lookups. Shared maps are timed on the wall clock.
+*/
+
+static double elapsed(std::clock_t start)
+{ return (static_cast<double>(std::clock() - start) * 1000 / CLOCKS_PER_SEC); }
+
+static double wall_elapsed(std::chrono::steady_clock::time_point start)
+{ return (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()); }
+
+template < class Map >
+void bench(const char* name, const std::vector<int>& keys, bool updates)
+{
+	Map m;
+	long sum = 0;
+	std::clock_t start;
+
+	std::cout << name << std::endl;
+
+	if (updates)
+	{
+		start = std::clock();
+		for (size_t i = 0; i < keys.size(); ++i)
+			m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+		std::cout << "  random insert   : " << elapsed(start) << std::endl;
+	}
+	else
+	{
+		std::vector< ft::pair<int, int> > values;
+		for (size_t i = 0; i < keys.size(); ++i)
+			values.push_back(ft::make_pair(keys[i], static_cast<int>(i)));
+		start = std::clock();
+		m.insert(&values[0], &values[0] + values.size());
+		std::cout << "  bulk build      : " << elapsed(start) << std::endl;
+	}
+
+	start = std::clock();
+	for (size_t i = 0; i < keys.size(); ++i)
+		sum += m.find(keys[i])->second;
+	std::cout << "  find hit        : " << elapsed(start) << std::endl;
+
+	start = std::clock();
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		typename Map::iterator it = m.lower_bound(keys[i] ^ 1);
+		if (it != m.end())
+			sum += it->first;
+	}
+	std::cout << "  lower_bound     : " << elapsed(start) << std::endl;
+
+	start = std::clock();
+	for (typename Map::iterator it = m.begin(); it != m.end(); ++it)
+		sum += it->second;
+	std::cout << "  full scan       : " << elapsed(start) << std::endl;
+
+	if (!updates)
+	{
+		std::cout << "  (checksum " << sum + m.size() << ")" << std::endl;
+		return ;
+	}
+
+	start = std::clock();
+	for (size_t i = 0; i < keys.size(); i += 2)
+		m.erase(keys[i]);
+	std::cout << "  erase half      : " << elapsed(start) << std::endl;
+
+	Map sorted;
+	start = std::clock();
+	for (size_t i = 0; i < keys.size(); ++i)
+		sorted[static_cast<int>(i)] = static_cast<int>(i);
+	std::cout << "  ascending []    : " << elapsed(start) << std::endl;
+
+	std::cout << "  (checksum " << sum + m.size() + sorted.size() << ")" << std::endl;
+}
+
+// Point queries only, for containers without order
+template < class Map >
+void bench_unordered(const char* name, const std::vector<int>& keys)
+{
+	Map m;
+	long sum = 0;
+	std::clock_t start;
+
+	std::cout << name << std::endl;
+
+	start = std::clock();
+	for (size_t i = 0; i < keys.size(); ++i)
+		m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+	std::cout << "  random insert   : " << elapsed(start) << std::endl;
+
+	start = std::clock();
+	for (size_t i = 0; i < keys.size(); ++i)
+		sum += m.find(keys[i])->second;
+	std::cout << "  find hit        : " << elapsed(start) << std::endl;
+
+	start = std::clock();
+	for (size_t i = 0; i < keys.size(); ++i)
+		sum += m.count(keys[i] ^ 1);
+	std::cout << "  find mostly miss: " << elapsed(start) << std::endl;
+
+	start = std::clock();
+	for (size_t i = 0; i < keys.size(); i += 2)
+		m.erase(keys[i]);
+	std::cout << "  erase half      : " << elapsed(start) << std::endl;
+
+	std::cout << "  (checksum " << sum + m.size() << ")" << std::endl;
+}
+
+// ft::map shared the usual way, behind one mutex
+struct locked_map
+{
+	std::mutex          lock;
+	ft::map<int, int>   map;
+
+	bool find(int k)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return (map.find(k) != map.end());
+	}
+
+	void insert(int k, int v)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		map.insert(ft::make_pair(k, v));
+	}
+
+	void erase(int k)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		map.erase(k);
+	}
+};
+
+struct shared_map
+{
+	ft::concurrent_map<int, int> map;
+
+	bool find(int k)
+	{ return (map.find(k) != map.end()); }
+
+	void insert(int k, int v)
+	{ map.insert(ft::make_pair(k, v)); }
+
+	void erase(int k)
+	{ map.erase(k); }
+};
+
+// The same operations split over more and more threads: 90% find,
+// 5% insert, 5% erase, on a map holding half of the keys
+template < class Shared >
+void bench_threads(const char* name, const std::vector<int>& keys, unsigned max_threads)
+{
+	std::cout << name << std::endl;
+
+	for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+	{
+		Shared m;
+		std::vector<std::thread> workers;
+		std::vector<long> sums(threads, 0);
+
+		for (size_t i = 0; i < keys.size(); i += 2)
+			m.insert(keys[i], static_cast<int>(i));
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned t = 0; t < threads; ++t)
+			workers.push_back(std::thread([&m, &keys, &sums, t, threads]()
+			{
+				for (size_t i = t; i < keys.size(); i += threads)
+				{
+					int key = keys[(i * 7919) % keys.size()];
+
+					if (i % 20 == 0)
+						m.insert(key, static_cast<int>(i));
+					else if (i % 20 == 1)
+						m.erase(key);
+					else
+						sums[t] += m.find(key);
+				}
+			}));
+		for (unsigned t = 0; t < threads; ++t)
+			workers[t].join();
+		std::cout << "  " << threads << (threads < 10 ? " " : "") << " thread(s)    : " << wall_elapsed(start) << std::endl;
+	}
+}
+
+int main(int ac, char** av)
+{
+	size_t n = (ac > 1) ? std::strtoul(av[1], nullptr, 10) : 1000000;
+	std::vector<int> keys(n);
+
+	std::srand(42);
+	for (size_t i = 0; i < n; ++i)
+		keys[i] = std::rand();
+
+	bench< ft::map<int, int> >("ft::map", keys, true);
+	bench< ft::btree_map<int, int> >("ft::btree_map", keys, true);
+	bench< ft::map<int, int> >("ft::map (bulk)", keys, false);
+	bench< ft::flat_map<int, int> >("ft::flat_map (bulk)", keys, false);
+	bench_unordered< ft::map<int, int> >("ft::map (point queries)", keys);
+	bench_unordered< ft::unordered_map<int, int> >("ft::unordered_map (point queries)", keys);
+
+	unsigned max_threads = std::thread::hardware_concurrency();
+	if (max_threads < 4)
+		max_threads = 4;
+	bench_threads<locked_map>("ft::map + mutex (shared)", keys, max_threads);
+	bench_threads<shared_map>("ft::concurrent_map (shared)", keys, max_threads);
+	return (0);
+}
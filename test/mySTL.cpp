@@ -1,10 +1,185 @@
 #include "./../map.hpp"
+#include "./../set.hpp"
 #include "./../vector.hpp"
 #include "./../stack.hpp"
+#include "./../btreeMap.hpp"
+#include "./../flatMap.hpp"
+#include "./../unorderedMap.hpp"
+#include "./../persistentMap.hpp"
+#include "./../concurrentMap.hpp"
 #include <fstream>
+#include <iterator>
 #include <sstream>
+#include <thread>
 #define namespace	ft
 
+// ft only containers and their std equivalents
+typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::avl_balance> avl_map;
+typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::no_balance> unbalanced_map;
+// small nodes, so that a few hundred keys already make a three level tree
+typedef ft::btree_map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, 64> btree_map;
+typedef ft::flat_map<int, int> flat_map;
+typedef ft::unordered_map<int, int> unordered_map;
+typedef ft::persistent_map<int, int> persistent_map;
+typedef ft::concurrent_map<int, int> concurrent_map;
+typedef ft::map<int, std::string>::node_handle_type string_map_handle;
+
+// A map sharing the node pool of m
+template < class Map >
+Map shared_pool_map(Map& m)
+{ return (Map(m.get_node_allocator())); }
+
+typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >,
+	ft::red_black_balance, ft::order_statistics> counted_map;
+
+// split and join, std::map does them with extract and merge
+template < class Map >
+Map split_map(Map& m, int k)
+{ return (m.split(k)); }
+
+template < class Map >
+void join_map(Map& m, Map& x)
+{ m.join(x); }
+
+// Frozen version of m, a copy of a std::map is one too
+template < class Map >
+Map snapshot_map(const Map& m)
+{ return (m.snapshot()); }
+
+// Runs work(m, 0) .. work(m, threads - 1) on as many threads, std::map
+// runs them one after the other
+template < class Map, class Work >
+void run_threads(Map& m, int threads, Work work)
+{
+	std::vector<std::thread> pool;
+
+	for (int t = 0; t < threads; ++t)
+		pool.push_back(std::thread(work, std::ref(m), t));
+	for (int t = 0; t < threads; ++t)
+		pool[t].join();
+}
+
+// Member set operations, std::map runs the algorithms into an inserter
+template < class Map >
+Map map_union(const Map& a, const Map& b)
+{ return (a.set_union(b)); }
+
+template < class Map >
+Map map_intersection(const Map& a, const Map& b)
+{ return (a.set_intersection(b)); }
+
+template < class Map >
+Map map_difference(const Map& a, const Map& b)
+{ return (a.set_difference(b)); }
+
+// Insert, erase and walk sequences, run on every balancing policy of ft::map
+template < class Map >
+void test_balance(std::ofstream& fileout, const char* name)
+{
+	Map m;
+	typename Map::iterator it;
+
+	fileout << "\n\n TESTING " << name << " \n" << std::endl;
+	for (int i = 0; i < 500; ++i)
+		m.insert(namespace::make_pair(i, i));
+	for (int i = 999; i >= 500; --i)
+		m[i] = -i;
+	for (int i = 0; i < 1000; ++i)
+		m.insert(namespace::make_pair((i * 7919) % 1500, i));
+	for (int i = 0; i < 1500; i += 3)
+		m.erase((i * 37) % 1500);
+	m.erase(m.begin(), m.lower_bound(40));
+	m.erase(m.lower_bound(1400), m.end());
+	fileout << "size : " << m.size() << std::endl;
+	long sum = 0;
+	for (it = m.begin(); it != m.end(); ++it)
+	{
+		sum += it->first * 3 + it->second;
+		if (it->first % 97 == 0)
+			fileout << "[" << name << "] key = " << it->first << "  value = " << it->second << std::endl;
+	}
+	for (it = --m.end(); it != m.begin(); --it)
+		if (it->first % 233 == 0)
+			fileout << "[" << name << "] key = " << it->first << "  value = " << it->second << std::endl;
+	fileout << "checksum : " << sum << std::endl;
+	fileout << "lower_bound(700) : " << m.lower_bound(700)->first
+		<< "  upper_bound(700) : " << m.upper_bound(700)->first << std::endl;
+}
+
+// Splits a map at several keys and joins the parts back, on one pool
+// (tree surgery, nodes stay in place) or from another map
+template < class Map >
+void test_split(std::ofstream& fileout, const char* name)
+{
+	Map m;
+
+	fileout << "\n\n TESTING SPLIT AND JOIN " << name << " \n" << std::endl;
+	for (int i = 0; i < 2000; ++i)
+		m.insert(namespace::make_pair((i * 7919) % 4001, i));
+	int cuts[6] = { -5, 0, 1234, 2000, 3999, 5000 };
+	for (int i = 0; i < 6; ++i)
+	{
+		const int* before = m.empty() ? nullptr : &m.begin()->first;
+		Map upper = split_map(m, cuts[i]);
+		fileout << "split(" << cuts[i] << ") : " << m.size() << " + " << upper.size();
+		if (!m.empty())
+			fileout << "  low max = " << (--m.end())->first;
+		if (!upper.empty())
+			fileout << "  high min = " << upper.begin()->first;
+		join_map(m, upper);
+		fileout << "  joined : " << m.size() << "  left : " << upper.size()
+			<< "  same node : " << (before == nullptr || before == &m.begin()->first) << std::endl;
+	}
+	Map low = split_map(m, 1000);
+	Map high = split_map(m, 3000);
+	join_map(high, low);
+	fileout << "low and high joined : " << high.size() << "  middle : " << m.size()
+		<< "  " << high.begin()->first << " " << (--high.end())->first << std::endl;
+	join_map(m, high);
+	Map other;
+	for (int i = 5000; i < 5100; ++i)
+		other[i] = -i;
+	join_map(m, other);
+	Map overlap;
+	overlap[4000] = 0;
+	overlap[17] = 1;
+	join_map(m, overlap);
+	fileout << "size : " << m.size() << "  other left : " << other.size() << "  overlap left : " << overlap.size() << std::endl;
+	long sum = 0;
+	for (typename Map::iterator it = m.begin(); it != m.end(); ++it)
+		sum += it->first * 7 + it->second;
+	fileout << "checksum : " << sum << std::endl;
+}
+
+// Updates of one thread, run in two rounds: every thread inserts the same
+// shared keys and its own ones, then erases the same shared keys and half
+// of its own; only one insert or erase of a key may succeed, whatever the
+// interleaving
+static long g_inserted[4];
+static long g_erased[4];
+
+template < class Map >
+void concurrent_inserts(Map& m, int t)
+{
+	for (int i = 0; i < 3000; ++i)
+	{
+		g_inserted[t] += m.insert(namespace::make_pair((i * 7919) % 3001, i)).second;
+		g_inserted[t] += m.insert(namespace::make_pair(10000 + t * 3000 + i, t)).second;
+	}
+}
+
+template < class Map >
+void concurrent_erases(Map& m, int t)
+{
+	for (int i = 0; i < 3000; ++i)
+	{
+		if (i % 2 == 0)
+			g_erased[t] += m.erase(10000 + t * 3000 + i);
+		if (i % 3 == 0)
+			g_erased[t] += m.erase((i * 13) % 3001);
+	}
+}
+
 int main()
 {
 	std::ofstream fileout ("STL_output.txt");
@@ -83,6 +258,17 @@ int main()
 	for(it1 = vec3.begin(); it1 != vec3.end(); ++it1)
 		fileout << "[vec3] : " << *it1 << std::endl;
 
+	fileout << "\n\nTESTING COPIES OF AN EMPTY VECTOR\n" << std::endl;
+	namespace::vector<int> vec4;
+	namespace::vector<int> vec5(vec4);
+	namespace::vector<int> vec6(0, 1);
+	vec5.push_back(3);
+	vec3 = vec4;
+	vec3.push_back(2);
+	vec6.push_back(4);
+	fileout << "size : " << vec5.size() << " " << vec3.size() << " " << vec6.size()
+		<< "  values : " << vec5[0] << " " << vec3[0] << " " << vec6[0] << std::endl;
+
 
 	fileout << "\n\n************** TESTING STACK **************\n" << std::endl;
 	namespace::stack<int, namespace::vector<int> > stack1 (vec2);
@@ -134,4 +320,293 @@ int main()
 	fileout << "max_size : " << map1.max_size() << std::endl;
 	for(it = map1.begin(); it != map1.end(); ++it)
 		fileout << "[map1] key = " << it->first << "  value = " << it->second << std::endl;
-}
\ No newline at end of file
+
+	fileout << " TESTING SORTED INSERT AND ERASE \n" << std::endl;
+	namespace::map<int, int> map3;
+	for (int i = 0; i < 1000; i++)
+		map3.insert(namespace::pair<int, int>(i, i * 2));
+	for (int i = 0; i < 1000; i += 3)
+		map3.erase(i);
+	fileout << "size : " << map3.size() << std::endl;
+	namespace::map<int, int>::iterator it3;
+	for(it3 = map3.begin(); it3 != map3.end(); ++it3)
+		if (it3->first % 100 < 3)
+			fileout << "[map3] key = " << it3->first << "  value = " << it3->second << std::endl;
+	for(it3 = --map3.end(); it3 != map3.begin(); --it3)
+		if (it3->first % 250 < 2)
+			fileout << "[map3] key = " << it3->first << "  value = " << it3->second << std::endl;
+
+	fileout << "\n\n TESTING BOUNDS AND COUNT \n" << std::endl;
+	fileout << "lower_bound(300) : " << map3.lower_bound(300)->first << std::endl;
+	fileout << "lower_bound(301) : " << map3.lower_bound(301)->first << std::endl;
+	fileout << "upper_bound(301) : " << map3.upper_bound(301)->first << std::endl;
+	fileout << "upper_bound(999) == end : " << (map3.upper_bound(999) == map3.end()) << std::endl;
+	fileout << "equal_range(500) : " << map3.equal_range(500).first->first
+		<< " " << map3.equal_range(500).second->first << std::endl;
+	fileout << "equal_range(501) : " << map3.equal_range(501).first->first
+		<< " " << map3.equal_range(501).second->first << std::endl;
+	fileout << "count(300) : " << map3.count(300) << "  count(301) : " << map3.count(301) << std::endl;
+
+	fileout << "\n\n TESTING STRING KEYS \n" << std::endl;
+	namespace::map<std::string, int> map4;
+	map4["pear"] = 1;
+	map4["apple"] = 2;
+	map4["fig"] = 3;
+	map4["banana"] = 4;
+	map4["apple"] = 5;
+	map4.insert(namespace::pair<std::string, int>("cherry", 6));
+	map4.erase("fig");
+	fileout << "size : " << map4.size() << std::endl;
+	for(namespace::map<std::string, int>::iterator it4 = map4.begin(); it4 != map4.end(); ++it4)
+		fileout << "[map4] key = " << it4->first << "  value = " << it4->second << std::endl;
+	fileout << "lower_bound(\"b\") : " << map4.lower_bound("b")->first << std::endl;
+
+	fileout << "\n\n TESTING RANGE CONSTRUCTOR \n" << std::endl;
+	namespace::pair<int, int> sorted[6] = { namespace::make_pair(1, 1), namespace::make_pair(3, 3),
+		namespace::make_pair(3, 4), namespace::make_pair(5, 5), namespace::make_pair(2, 2), namespace::make_pair(4, 4) };
+	namespace::map<int, int> map5(sorted, sorted + 6);
+	fileout << "size : " << map5.size() << std::endl;
+	for(it3 = map5.begin(); it3 != map5.end(); ++it3)
+		fileout << "[map5] key = " << it3->first << "  value = " << it3->second << std::endl;
+
+	fileout << "\n\n TESTING EXTRACT AND MERGE \n" << std::endl;
+	namespace::map<int, int> map6;
+	namespace::map<int, int> map7;
+	for (int i = 0; i < 8; ++i)
+	{
+		map6[i] = i * 10;
+		map7[i * 2] = i * 100;
+	}
+	fileout << "insert(extract(3)) : " << map7.insert(map6.extract(3)).inserted << std::endl;
+	fileout << "insert(extract(4)) : " << map7.insert(map6.extract(4)).inserted << std::endl;
+	fileout << "extract(42) empty : " << map6.extract(42).empty() << std::endl;
+	map6.merge(map7);
+	fileout << "sizes : " << map6.size() << " " << map7.size() << std::endl;
+	for(it3 = map6.begin(); it3 != map6.end(); ++it3)
+		fileout << "[map6] key = " << it3->first << "  value = " << it3->second << std::endl;
+	for(it3 = map7.begin(); it3 != map7.end(); ++it3)
+		fileout << "[map7] key = " << it3->first << "  value = " << it3->second << std::endl;
+
+	fileout << "\n\n TESTING RELATIONAL OPERATORS AND SET ALGORITHMS \n" << std::endl;
+	namespace::map<int, int> map8(map6);
+	fileout << "map6 == map8 : " << (map6 == map8) << "  map6 != map7 : " << (map6 != map7) << std::endl;
+	map8[3] = 31;
+	fileout << "map6 < map8 : " << (map6 < map8) << "  map6 >= map8 : " << (map6 >= map8) << std::endl;
+	fileout << "map7 > map6 : " << (map7 > map6) << "  map7 <= map6 : " << (map7 <= map6) << std::endl;
+	namespace::map<int, int> map9;
+	namespace::set_intersection(map6.begin(), map6.end(), map7.begin(), map7.end(),
+		std::inserter(map9, map9.end()), map6.value_comp());
+	namespace::set_difference(map6.begin(), map6.end(), map8.begin(), map8.end(),
+		std::inserter(map9, map9.end()));
+	for(it3 = map9.begin(); it3 != map9.end(); ++it3)
+		fileout << "[map9] key = " << it3->first << "  value = " << it3->second << std::endl;
+	namespace::map<int, int> smap1;
+	namespace::map<int, int> smap2;
+	for (int i = 0; i < 40; i += 2)
+		smap1[i] = i;
+	for (int i = 0; i < 60; i += 3)
+		smap2[i] = -i;
+	namespace::map<int, int> smap3 = map_union(smap1, smap2);
+	namespace::map<int, int> smap4 = map_intersection(smap1, smap2);
+	namespace::map<int, int> smap5 = map_difference(smap2, smap1);
+	namespace::map<int, int> smap6 = map_union(smap5, namespace::map<int, int>());
+	fileout << "union : " << smap3.size() << "  intersection : " << smap4.size()
+		<< "  difference : " << smap5.size() << "  with empty : " << (smap6 == smap5) << std::endl;
+	for(it3 = smap3.begin(); it3 != smap3.end(); ++it3)
+		fileout << "[smap3] key = " << it3->first << "  value = " << it3->second << std::endl;
+	for(it3 = smap4.begin(); it3 != smap4.end(); ++it3)
+		fileout << "[smap4] key = " << it3->first << "  value = " << it3->second << std::endl;
+	for(it3 = smap5.begin(); it3 != smap5.end(); ++it3)
+		fileout << "[smap5] key = " << it3->first << "  value = " << it3->second << std::endl;
+	smap4[1000] = 0;
+	fileout << "independent results : " << smap3.count(1000) << " " << smap4.size() << std::endl;
+
+	fileout << "\n\n TESTING NODE IDENTITY ON A SHARED POOL \n" << std::endl;
+	namespace::map<int, std::string> pmap1;
+	for (int i = 0; i < 10; ++i)
+		pmap1[i] = std::string(i + 1, 'a' + i);
+	namespace::map<int, std::string> pmap2 = shared_pool_map(pmap1);
+	string_map_handle nh = pmap1.extract(3);
+	const int* before = &nh.key();
+	namespace::map<int, std::string>::insert_return_type ret = pmap2.insert(static_cast<string_map_handle&&>(nh));
+	fileout << "inserted : " << ret.inserted << "  same node : " << (&ret.position->first == before)
+		<< "  handle empty : " << nh.empty() << std::endl;
+	before = &pmap1.find(7)->first;
+	pmap2.merge(pmap1);
+	fileout << "merged size : " << pmap2.size() << "  left : " << pmap1.size()
+		<< "  same node : " << (&pmap2.find(7)->first == before) << std::endl;
+	nh = pmap2.extract(pmap2.begin());
+	before = &nh.key();
+	nh.key() = 42;
+	pmap2.insert(static_cast<string_map_handle&&>(nh));
+	fileout << "re-keyed : " << pmap2.count(0) << " " << pmap2[42] << "  same node : " << (&pmap2.find(42)->first == before) << std::endl;
+
+	fileout << "\n\n TESTING TRY_EMPLACE AND INSERT_OR_ASSIGN \n" << std::endl;
+	fileout << "try_emplace(\"kiwi\") : " << map4.try_emplace("kiwi", 7).second << std::endl;
+	fileout << "try_emplace(\"pear\") : " << map4.try_emplace("pear", 8).second << std::endl;
+	fileout << "insert_or_assign(\"pear\") : " << map4.insert_or_assign("pear", 9).second << std::endl;
+	fileout << "insert_or_assign(\"plum\") : " << map4.insert_or_assign("plum", 10).second << std::endl;
+	for(namespace::map<std::string, int>::iterator it4 = map4.begin(); it4 != map4.end(); ++it4)
+		fileout << "[map4] key = " << it4->first << "  value = " << it4->second << std::endl;
+
+	test_balance<namespace::map<int, int> >(fileout, "red_black_balance");
+	test_balance<avl_map>(fileout, "avl_balance");
+	test_balance<unbalanced_map>(fileout, "no_balance");
+
+	test_split<namespace::map<int, int> >(fileout, "red_black_balance");
+	test_split<avl_map>(fileout, "avl_balance");
+	test_split<unbalanced_map>(fileout, "no_balance");
+	test_split<counted_map>(fileout, "order_statistics");
+
+	fileout << "\n\n************** TESTING MULTIMAP **************\n" << std::endl;
+	namespace::multimap<int, int> mmap1;
+	for (int i = 0; i < 12; ++i)
+		mmap1.insert(namespace::make_pair(i % 4, i));
+	mmap1.insert(mmap1.lower_bound(2), namespace::make_pair(2, 100));
+	fileout << "size : " << mmap1.size() << "  count(2) : " << mmap1.count(2) << std::endl;
+	for(namespace::multimap<int, int>::iterator it6 = mmap1.begin(); it6 != mmap1.end(); ++it6)
+		fileout << "[mmap1] key = " << it6->first << "  value = " << it6->second << std::endl;
+	fileout << "erase(1) : " << mmap1.erase(1) << "  size : " << mmap1.size() << std::endl;
+	fileout << "equal_range(3) : " << mmap1.equal_range(3).first->second
+		<< " " << (mmap1.equal_range(3).second == mmap1.end()) << std::endl;
+	namespace::multimap<int, int> mmap2;
+	mmap2.insert(namespace::make_pair(5, 1));
+	mmap2.insert(namespace::make_pair(5, 2));
+	mmap2.insert(mmap2.begin(), namespace::make_pair(5, 3));
+	mmap2.insert(mmap2.end(), namespace::make_pair(5, 4));
+	mmap2.insert(++mmap2.begin(), namespace::make_pair(5, 5));
+	mmap2.insert(mmap2.begin(), namespace::make_pair(6, 6));
+	mmap2.insert(mmap2.find(6), namespace::make_pair(4, 7));
+	mmap2.insert(mmap2.begin(), namespace::make_pair(5, 8));
+	for(namespace::multimap<int, int>::iterator it6 = mmap2.begin(); it6 != mmap2.end(); ++it6)
+		fileout << "[mmap2] key = " << it6->first << "  value = " << it6->second << std::endl;
+
+	fileout << "\n\n************** TESTING SET **************\n" << std::endl;
+	int keys[10] = { 5, 1, 4, 1, 5, 9, 2, 6, 5, 3 };
+	namespace::set<int> set1;
+	namespace::multiset<int> mset1;
+	for (int i = 0; i < 10; ++i)
+	{
+		fileout << "insert(" << keys[i] << ") : " << set1.insert(keys[i]).second << std::endl;
+		mset1.insert(keys[i]);
+	}
+	fileout << "size : " << set1.size() << "  multiset size : " << mset1.size() << std::endl;
+	for(namespace::set<int>::iterator it7 = set1.begin(); it7 != set1.end(); ++it7)
+		fileout << "[set1] : " << *it7 << std::endl;
+	for(namespace::multiset<int>::reverse_iterator it8 = mset1.rbegin(); it8 != mset1.rend(); ++it8)
+		fileout << "[mset1] : " << *it8 << std::endl;
+	fileout << "count(5) : " << set1.count(5) << "  multiset count(5) : " << mset1.count(5) << std::endl;
+	fileout << "erase(5) : " << set1.erase(5) << "  multiset erase(5) : " << mset1.erase(5) << std::endl;
+	fileout << "lower_bound(5) : " << *set1.lower_bound(5) << "  multiset upper_bound(1) : " << *mset1.upper_bound(1) << std::endl;
+
+	fileout << "\n\n************** TESTING BTREE_MAP **************\n" << std::endl;
+	test_balance<btree_map>(fileout, "btree_map");
+	btree_map bmap1;
+	for (int i = 0; i < 300; i += 2)
+		bmap1.insert(bmap1.end(), namespace::make_pair(i, i));
+	for (int i = 299; i > 0; i -= 2)
+		bmap1.insert(bmap1.lower_bound(i), namespace::make_pair(i, -i));
+	fileout << "hint on a present key : " << bmap1.insert(bmap1.begin(), namespace::make_pair(10, 0))->second << std::endl;
+	for (int i = 0; i < 300; i += 3)
+		bmap1.erase(bmap1.find(i));
+	btree_map bmap2(bmap1);
+	bmap2.erase(bmap2.lower_bound(50), bmap2.lower_bound(250));
+	bmap1[1000] = 1;
+	fileout << "size : " << bmap1.size() << "  copy size : " << bmap2.size() << std::endl;
+	for (btree_map::iterator it9 = bmap2.begin(); it9 != bmap2.end(); ++it9)
+		fileout << "[bmap2] key = " << it9->first << "  value = " << it9->second << std::endl;
+	for (btree_map::reverse_iterator it10 = bmap1.rbegin(); it10 != bmap1.rend(); ++it10)
+		if (it10->first % 25 == 1)
+			fileout << "[bmap1] key = " << it10->first << "  value = " << it10->second << std::endl;
+
+	fileout << "\n\n************** TESTING FLAT_MAP **************\n" << std::endl;
+	test_balance<flat_map>(fileout, "flat_map");
+	namespace::vector<namespace::pair<int, int> > batch;
+	for (int i = 0; i < 60; ++i)
+		batch.push_back(namespace::make_pair((i * 13) % 41, i));
+	flat_map fmap1(batch.begin(), batch.end());
+	fmap1.insert(batch.begin() + 20, batch.end());
+	for (int i = 40; i < 50; ++i)
+		fmap1.insert(fmap1.end(), namespace::make_pair(i, -i));
+	fmap1.insert(fmap1.begin(), namespace::make_pair(45, 0));
+	fmap1.erase(fmap1.find(7));
+	fmap1.erase(fmap1.lower_bound(30), fmap1.upper_bound(35));
+	flat_map fmap2;
+	fmap2 = fmap1;
+	fmap2[100] = 100;
+	fileout << "size : " << fmap1.size() << "  copy size : " << fmap2.size() << std::endl;
+	for (flat_map::iterator it11 = fmap2.begin(); it11 != fmap2.end(); ++it11)
+		fileout << "[fmap2] key = " << it11->first << "  value = " << it11->second << std::endl;
+
+	// Iteration order is unspecified: only sums and lookups are printed
+	fileout << "\n\n************** TESTING UNORDERED_MAP **************\n" << std::endl;
+	unordered_map umap1;
+	for (int i = 0; i < 2000; ++i)
+		umap1.insert(namespace::make_pair((i * 7919) % 3001, i));
+	for (int i = 0; i < 3001; i += 2)
+		umap1.erase(i);
+	for (int i = 0; i < 500; ++i)
+		umap1[i * 5] += 1;
+	umap1.erase(umap1.find(5));
+	fileout << "insert of a present key : " << umap1.insert(namespace::make_pair(15, 0)).second << std::endl;
+	unordered_map umap2(umap1);
+	umap2.erase(umap2.begin(), umap2.end());
+	unordered_map umap3;
+	umap3 = umap1;
+	long usum = 0;
+	size_t walked = 0;
+	for (unordered_map::iterator it12 = umap3.begin(); it12 != umap3.end(); ++it12, ++walked)
+		usum += it12->first * 3 + it12->second;
+	fileout << "size : " << umap1.size() << "  walked : " << walked << "  checksum : " << usum
+		<< "  erased copy : " << umap2.size() << "  empty : " << umap2.empty() << std::endl;
+	for (int i = 0; i < 3001; i += 37)
+		if (umap1.count(i))
+			fileout << "[umap1] key = " << i << "  value = " << umap1.find(i)->second << std::endl;
+
+	fileout << "\n\n************** TESTING PERSISTENT_MAP **************\n" << std::endl;
+	persistent_map vmap1;
+	for (int i = 0; i < 1000; ++i)
+		vmap1.insert(namespace::make_pair((i * 7919) % 1999, i));
+	persistent_map vmap2 = snapshot_map(vmap1);
+	for (int i = 0; i < 1999; i += 3)
+		vmap1.erase(i);
+	for (int i = 0; i < 1999; i += 7)
+		vmap1.insert_or_assign(i, -i);
+	fileout << "insert of a present key : " << vmap1.insert(namespace::make_pair(7, 0)).second
+		<< "  value : " << vmap1.find(7)->second << "  erase of a missing key : " << vmap1.erase(3) << std::endl;
+	persistent_map vmap3 = snapshot_map(vmap1);
+	vmap1.clear();
+	for (int i = 0; i < 10; ++i)
+		vmap1.insert_or_assign(i, i);
+	long psum2 = 0;
+	long psum3 = 0;
+	for (persistent_map::const_iterator it13 = vmap2.begin(); it13 != vmap2.end(); ++it13)
+		psum2 += it13->first * 3 + it13->second;
+	for (persistent_map::const_iterator it13 = vmap3.begin(); it13 != vmap3.end(); ++it13)
+		psum3 += it13->first * 3 + it13->second;
+	fileout << "size : " << vmap1.size() << "  first snapshot : " << vmap2.size() << " " << psum2
+		<< "  second snapshot : " << vmap3.size() << " " << psum3 << std::endl;
+	for (int i = 0; i < 1999; i += 111)
+		fileout << "[vmap2] key = " << i << "  count = " << vmap2.count(i)
+			<< "  [vmap3] count = " << vmap3.count(i) << std::endl;
+
+	fileout << "\n\n************** TESTING CONCURRENT_MAP **************\n" << std::endl;
+	concurrent_map cmap1;
+	run_threads(cmap1, 4, concurrent_inserts<concurrent_map>);
+	run_threads(cmap1, 4, concurrent_erases<concurrent_map>);
+	long cinserted = 0;
+	long cerased = 0;
+	for (int t = 0; t < 4; ++t)
+	{
+		cinserted += g_inserted[t];
+		cerased += g_erased[t];
+	}
+	long csum = 0;
+	size_t cwalked = 0;
+	for (concurrent_map::const_iterator it14 = cmap1.begin(); it14 != cmap1.end(); ++it14, ++cwalked)
+		csum += it14->first;
+	fileout << "inserted : " << cinserted << "  erased : " << cerased << "  size : " << cmap1.size()
+		<< "  walked : " << cwalked << "  key sum : " << csum << std::endl;
+	for (int i = 0; i < 25000; i += 997)
+		fileout << "[cmap1] key = " << i << "  count = " << cmap1.count(i) << std::endl;
+}
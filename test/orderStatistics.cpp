@@ -0,0 +1,17 @@
+#include "../map.hpp"
+
+// Compiles with -DCOUNTED only: nth, rank and distance need order statistics
+#ifdef COUNTED
+typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >,
+	ft::red_black_balance, ft::order_statistics> map_type;
+#else
+typedef ft::map<int, int> map_type;
+#endif
+
+int main()
+{
+	map_type m;
+
+	m[1] = 1;
+	return (static_cast<int>(m.rank(1) + m.distance(m.begin(), m.end())) + (m.nth(0) == m.end()));
+}
@@ -0,0 +1,629 @@
+#ifndef TREEBALANCE_HPP
+#define TREEBALANCE_HPP
+
+namespace ft
+{
+	enum rb_color { rb_red, rb_black };
+
+	/*
+	** Balancing policies for ft::BST.
+	** Every policy exposes static hooks, resolved at compile time:
+	**   insert_rebalance(node, header) : node has just been linked as a leaf
+	**   erase_rebalance(node, header)  : unlinks node (not freed) from the tree
+	**   built(node, bottom, lh, rh)    : node belongs to a tree bulk built with
+	**                                    every leaf on the last two levels;
+	**                                    bottom is set on an incomplete last level
+	**   join(left, mid, right, header) : links the trees left and right (either
+	**                                    may be nullptr), whose keys sort before
+	**                                    and after the lone node mid, into one
+	**                                    tree rooted under header
+	**   join(left, lh, mid, right, rh, header) : same with the heights of left
+	**                                    and right known, returns the height of
+	**                                    the result: O(|lh - rh| + 1)
+	**   join_height(root)              : height of a tree as join() means it, O(h)
+	**   child_heights(node, h, lh, rh) : heights of the subtrees of a node of
+	**                                    height h, O(1)
+	** header is the tree sentinel: header->parent() is the root, and leaves are
+	** nullptr. node->meta() is reserved to the policy (color, balance factor).
+	*/
+	struct tree_balance_base
+	{
+		// Side of a parent whose subtree lost a level during an erase
+		template < class NodePtr >
+		struct unlinked
+		{
+			NodePtr child;
+			NodePtr parent;
+			bool    left;
+			signed char meta;
+		};
+
+		// Makes new_node take node's place under node's parent (or as root)
+		template < class NodePtr >
+		static void replace_child(NodePtr node, NodePtr new_node, NodePtr header)
+		{
+			if (new_node != nullptr)
+				new_node->set_parent(node->parent());
+			if (node->parent() == header)
+				header->set_parent(new_node);
+			else if (node == node->parent()->left)
+				node->parent()->left = new_node;
+			else
+				node->parent()->right = new_node;
+		}
+
+		// Hooks y = node->right in place of node, node becomes y's left child
+		template < class NodePtr >
+		static NodePtr rotate_left(NodePtr node, NodePtr header)
+		{
+			NodePtr y = node->right;
+
+			node->right = y->left;
+			if (y->left != nullptr)
+				y->left->set_parent(node);
+			replace_child(node, y, header);
+			y->left = node;
+			node->set_parent(y);
+			node->pull();
+			y->pull();
+			return (y);
+		}
+
+		// Hooks y = node->left in place of node, node becomes y's right child
+		template < class NodePtr >
+		static NodePtr rotate_right(NodePtr node, NodePtr header)
+		{
+			NodePtr y = node->left;
+
+			node->left = y->right;
+			if (y->right != nullptr)
+				y->right->set_parent(node);
+			replace_child(node, y, header);
+			y->right = node;
+			node->set_parent(y);
+			node->pull();
+			y->pull();
+			return (y);
+		}
+
+		// Unlinks node, moving its in-order successor into its place when it
+		// has two children; the successor inherits node's meta. Returns where
+		// the tree lost a level and the meta of the position that disappeared.
+		template < class NodePtr >
+		static unlinked<NodePtr> unlink(NodePtr node, NodePtr header)
+		{
+			unlinked<NodePtr> res;
+
+			res.meta = node->meta();
+			if (node->left == nullptr || node->right == nullptr)
+			{
+				res.child = (node->left != nullptr) ? node->left : node->right;
+				res.parent = node->parent();
+				res.left = (node->parent() != header && node == node->parent()->left);
+				replace_child(node, res.child, header);
+				res.parent->pull_path(header);
+				return (res);
+			}
+
+			NodePtr successor = node->right;
+			while (successor->left != nullptr)
+				successor = successor->left;
+			res.meta = successor->meta();
+			res.child = successor->right;
+			if (successor->parent() == node)
+			{
+				res.parent = successor;
+				res.left = false;
+			}
+			else
+			{
+				res.parent = successor->parent();
+				res.left = true;
+				replace_child(successor, res.child, header);
+				successor->right = node->right;
+				successor->right->set_parent(successor);
+			}
+			replace_child(node, successor, header);
+			successor->left = node->left;
+			successor->left->set_parent(successor);
+			successor->set_meta(node->meta());
+			res.parent->pull_path(header);
+			return (res);
+		}
+
+		// mid becomes the root of the tree under header, over left and right
+		template < class NodePtr >
+		static void join_at_root(NodePtr left, NodePtr mid, NodePtr right, NodePtr header)
+		{
+			mid->left = left;
+			if (left != nullptr)
+				left->set_parent(mid);
+			mid->right = right;
+			if (right != nullptr)
+				right->set_parent(mid);
+			mid->set_parent(header);
+			header->set_parent(mid);
+			mid->pull();
+		}
+
+		// mid takes the place of the right (or left) child of parent, which
+		// becomes mid's child on the same side; other goes on mid's free side
+		template < class NodePtr >
+		static void join_below(NodePtr parent, bool right, NodePtr mid, NodePtr other, NodePtr header)
+		{
+			NodePtr child = right ? parent->right : parent->left;
+
+			mid->left = right ? child : other;
+			mid->right = right ? other : child;
+			if (child != nullptr)
+				child->set_parent(mid);
+			if (other != nullptr)
+				other->set_parent(mid);
+			if (right)
+				parent->right = mid;
+			else
+				parent->left = mid;
+			mid->set_parent(parent);
+			mid->pull_path(header);
+		}
+
+		// Makes root the root of the tree under header
+		template < class NodePtr >
+		static void set_root(NodePtr root, NodePtr header)
+		{
+			header->set_parent(root);
+			if (root != nullptr)
+				root->set_parent(header);
+		}
+	};
+
+	/* Plain binary search tree: no rebalancing at all */
+	struct no_balance : public tree_balance_base
+	{
+		template < class NodePtr >
+		static void insert_rebalance(NodePtr, NodePtr) {}
+
+		template < class NodePtr >
+		static void built(NodePtr, bool, int, int) {}
+
+		template < class NodePtr >
+		static void erase_rebalance(NodePtr node, NodePtr header)
+		{ unlink(node, header); }
+
+		template < class NodePtr >
+		static void join(NodePtr left, NodePtr mid, NodePtr right, NodePtr header)
+		{ join_at_root(left, mid, right, header); }
+
+		// Heights are not tracked
+		template < class NodePtr >
+		static int join(NodePtr left, int, NodePtr mid, NodePtr right, int, NodePtr header)
+		{
+			join_at_root(left, mid, right, header);
+			return (0);
+		}
+
+		template < class NodePtr >
+		static int join_height(NodePtr)
+		{ return (0); }
+
+		template < class NodePtr >
+		static void child_heights(NodePtr, int, int& left_height, int& right_height)
+		{
+			left_height = 0;
+			right_height = 0;
+		}
+	};
+
+	/* Red-black tree: cheap rebalancing, height <= 2 * log2(n + 1) */
+	struct red_black_balance : public tree_balance_base
+	{
+		template < class NodePtr >
+		static bool is_black(NodePtr node)
+		{ return (node == nullptr || node->meta() == rb_black); }
+
+		// Restores the red-black properties after node has been linked as a red
+		// leaf; true when the root had turned red, i.e. the black height grew
+		template < class NodePtr >
+		static bool insert_rebalance(NodePtr node, NodePtr header)
+		{
+			while (node != header->parent() && node->parent()->meta() == rb_red)
+			{
+				NodePtr parent = node->parent();
+				NodePtr grandparent = parent->parent();
+
+				if (parent == grandparent->left)
+				{
+					NodePtr uncle = grandparent->right;
+					if (!is_black(uncle))
+					{
+						parent->set_meta(rb_black);
+						uncle->set_meta(rb_black);
+						grandparent->set_meta(rb_red);
+						node = grandparent;
+						continue ;
+					}
+					if (node == parent->right)
+						parent = rotate_left(parent, header);
+					parent->set_meta(rb_black);
+					grandparent->set_meta(rb_red);
+					rotate_right(grandparent, header);
+					break ;
+				}
+				else
+				{
+					NodePtr uncle = grandparent->left;
+					if (!is_black(uncle))
+					{
+						parent->set_meta(rb_black);
+						uncle->set_meta(rb_black);
+						grandparent->set_meta(rb_red);
+						node = grandparent;
+						continue ;
+					}
+					if (node == parent->left)
+						parent = rotate_right(parent, header);
+					parent->set_meta(rb_black);
+					grandparent->set_meta(rb_red);
+					rotate_left(grandparent, header);
+					break ;
+				}
+			}
+			bool grown = (header->parent()->meta() == rb_red);
+			header->parent()->set_meta(rb_black);
+			return (grown);
+		}
+
+		// Only an incomplete last level is red, every path keeps the same black count
+		template < class NodePtr >
+		static void built(NodePtr node, bool bottom, int, int)
+		{ node->set_meta(bottom ? rb_red : rb_black); }
+
+		// Black nodes on a path from node down to a leaf, counting node as
+		// black: the black height it has as the root of a tree
+		template < class NodePtr >
+		static int join_height(NodePtr node)
+		{
+			int height = (node != nullptr && node->meta() == rb_red) ? 1 : 0;
+
+			for (; node != nullptr; node = node->left)
+				if (node->meta() == rb_black)
+					height++;
+			return (height);
+		}
+
+		// A red child has as many black nodes under it as its parent
+		template < class NodePtr >
+		static void child_heights(NodePtr node, int height, int& left_height, int& right_height)
+		{
+			left_height = height - (is_black(node->left) ? 1 : 0);
+			right_height = height - (is_black(node->right) ? 1 : 0);
+		}
+
+		template < class NodePtr >
+		static void join(NodePtr left, NodePtr mid, NodePtr right, NodePtr header)
+		{ join(left, join_height(left), mid, right, join_height(right), header); }
+
+		// With both roots black, the taller tree is walked down its inner
+		// spine to a black node as high as the other tree; mid goes there,
+		// red, over both, and a red-red link is fixed as after an insertion
+		template < class NodePtr >
+		static int join(NodePtr left, int left_height, NodePtr mid, NodePtr right, int right_height, NodePtr header)
+		{
+			if (left != nullptr)
+				left->set_meta(rb_black);
+			if (right != nullptr)
+				right->set_meta(rb_black);
+
+			if (left_height == right_height)
+			{
+				join_at_root(left, mid, right, header);
+				mid->set_meta(rb_black);
+				return (left_height + 1);
+			}
+
+			bool go_right = (left_height > right_height);
+			NodePtr node = go_right ? left : right;
+			NodePtr parent = nullptr;
+			int top = go_right ? left_height : right_height;
+			int height = top;
+			int target = go_right ? right_height : left_height;
+
+			set_root(node, header);
+			while (!is_black(node) || height != target)
+			{
+				if (is_black(node))
+					height--;
+				parent = node;
+				node = go_right ? node->right : node->left;
+			}
+			mid->set_meta(rb_red);
+			join_below(parent, go_right, mid, go_right ? right : left, header);
+			return (insert_rebalance(mid, header) ? top + 1 : top);
+		}
+
+		// Once a black position has been unlinked, child (possibly nullptr)
+		// carries an extra black on the given side of parent
+		template < class NodePtr >
+		static void erase_rebalance(NodePtr node, NodePtr header)
+		{
+			unlinked<NodePtr> pos = unlink(node, header);
+			NodePtr child = pos.child;
+			NodePtr parent = pos.parent;
+			bool left = pos.left;
+
+			if (pos.meta != rb_black)
+				return ;
+			while (child != header->parent() && is_black(child))
+			{
+				if (left)
+				{
+					NodePtr sibling = parent->right;
+					if (sibling->meta() == rb_red)
+					{
+						sibling->set_meta(rb_black);
+						parent->set_meta(rb_red);
+						rotate_left(parent, header);
+						sibling = parent->right;
+					}
+					if (is_black(sibling->left) && is_black(sibling->right))
+					{
+						sibling->set_meta(rb_red);
+						child = parent;
+						parent = parent->parent();
+						left = (child == parent->left);
+						continue ;
+					}
+					if (is_black(sibling->right))
+					{
+						sibling->left->set_meta(rb_black);
+						sibling->set_meta(rb_red);
+						sibling = rotate_right(sibling, header);
+					}
+					sibling->set_meta(parent->meta());
+					parent->set_meta(rb_black);
+					sibling->right->set_meta(rb_black);
+					rotate_left(parent, header);
+				}
+				else
+				{
+					NodePtr sibling = parent->left;
+					if (sibling->meta() == rb_red)
+					{
+						sibling->set_meta(rb_black);
+						parent->set_meta(rb_red);
+						rotate_right(parent, header);
+						sibling = parent->left;
+					}
+					if (is_black(sibling->left) && is_black(sibling->right))
+					{
+						sibling->set_meta(rb_red);
+						child = parent;
+						parent = parent->parent();
+						left = (child == parent->left);
+						continue ;
+					}
+					if (is_black(sibling->left))
+					{
+						sibling->right->set_meta(rb_black);
+						sibling->set_meta(rb_red);
+						sibling = rotate_left(sibling, header);
+					}
+					sibling->set_meta(parent->meta());
+					parent->set_meta(rb_black);
+					sibling->left->set_meta(rb_black);
+					rotate_right(parent, header);
+				}
+				child = header->parent();
+			}
+			if (child != nullptr)
+				child->set_meta(rb_black);
+		}
+	};
+
+	/*
+	** AVL tree: meta is the balance factor height(right) - height(left),
+	** height <= 1.44 * log2(n + 2), so lookups descend less than red-black
+	*/
+	struct avl_balance : public tree_balance_base
+	{
+		// Rotates node, whose balance factor would be +-2, back into shape and
+		// returns the new subtree root; stored factors never leave [-1, 1]
+		template < class NodePtr >
+		static NodePtr fix(NodePtr node, int balance, NodePtr header)
+		{
+			if (balance > 0)
+			{
+				NodePtr right = node->right;
+				int right_balance = right->meta();
+
+				if (right_balance >= 0)
+				{
+					rotate_left(node, header);
+					node->set_meta((right_balance == 0) ? 1 : 0);
+					right->set_meta((right_balance == 0) ? -1 : 0);
+					return (right);
+				}
+				NodePtr pivot = right->left;
+				int pivot_balance = pivot->meta();
+				rotate_right(right, header);
+				rotate_left(node, header);
+				node->set_meta((pivot_balance == 1) ? -1 : 0);
+				right->set_meta((pivot_balance == -1) ? 1 : 0);
+				pivot->set_meta(0);
+				return (pivot);
+			}
+
+			NodePtr left = node->left;
+			int left_balance = left->meta();
+
+			if (left_balance <= 0)
+			{
+				rotate_right(node, header);
+				node->set_meta((left_balance == 0) ? -1 : 0);
+				left->set_meta((left_balance == 0) ? 1 : 0);
+				return (left);
+			}
+			NodePtr pivot = left->right;
+			int pivot_balance = pivot->meta();
+			rotate_left(left, header);
+			rotate_right(node, header);
+			node->set_meta((pivot_balance == -1) ? 1 : 0);
+			left->set_meta((pivot_balance == 1) ? -1 : 0);
+			pivot->set_meta(0);
+			return (pivot);
+		}
+
+		// Walks up while the subtree rooted at node has grown by one level
+		template < class NodePtr >
+		static void insert_rebalance(NodePtr node, NodePtr header)
+		{
+			while (node != header->parent())
+			{
+				NodePtr parent = node->parent();
+				int balance = parent->meta() + ((node == parent->left) ? -1 : 1);
+
+				if (balance == 0)
+				{
+					parent->set_meta(0);
+					return ;
+				}
+				if (balance == 1 || balance == -1)
+				{
+					parent->set_meta(balance);
+					node = parent;
+					continue ;
+				}
+				fix(parent, balance, header);
+				return ;
+			}
+		}
+
+		template < class NodePtr >
+		static void built(NodePtr node, bool, int left_height, int right_height)
+		{ node->set_meta(right_height - left_height); }
+
+		// Levels of the subtree under node, following its taller side
+		template < class NodePtr >
+		static int height(NodePtr node)
+		{
+			int levels = 0;
+
+			for (; node != nullptr; node = (node->meta() < 0) ? node->left : node->right)
+				levels++;
+			return (levels);
+		}
+
+		template < class NodePtr >
+		static int join_height(NodePtr node)
+		{ return (height(node)); }
+
+		// The balance factor tells which side is a level lower
+		template < class NodePtr >
+		static void child_heights(NodePtr node, int height, int& left_height, int& right_height)
+		{
+			left_height = height - ((node->meta() > 0) ? 2 : 1);
+			right_height = height - ((node->meta() < 0) ? 2 : 1);
+		}
+
+		template < class NodePtr >
+		static void join(NodePtr left, NodePtr mid, NodePtr right, NodePtr header)
+		{ join(left, height(left), mid, right, height(right), header); }
+
+		// The taller tree is walked down its inner spine to a subtree at most
+		// one level higher than the other tree, mid goes there over both, then
+		// balance factors are fixed going up. Unlike after an insertion, a
+		// rotation may leave the subtree a level higher: the walk goes on, and
+		// the whole tree grows when it reaches the root.
+		template < class NodePtr >
+		static int join(NodePtr left, int left_height, NodePtr mid, NodePtr right, int right_height, NodePtr header)
+		{
+			if (left_height - right_height <= 1 && right_height - left_height <= 1)
+			{
+				join_at_root(left, mid, right, header);
+				mid->set_meta(right_height - left_height);
+				return ((left_height > right_height ? left_height : right_height) + 1);
+			}
+
+			bool go_right = (left_height > right_height);
+			NodePtr node = go_right ? left : right;
+			NodePtr parent = nullptr;
+			int top = go_right ? left_height : right_height;
+			int levels = top;
+			int target = (go_right ? right_height : left_height) + 1;
+
+			set_root(node, header);
+			while (levels > target)
+			{
+				parent = node;
+				if (go_right)
+				{
+					levels -= (node->meta() >= 0) ? 1 : 2;
+					node = node->right;
+				}
+				else
+				{
+					levels -= (node->meta() <= 0) ? 1 : 2;
+					node = node->left;
+				}
+			}
+			join_below(parent, go_right, mid, go_right ? right : left, header);
+			mid->set_meta(go_right ? (target - 1 - levels) : (levels - target + 1));
+
+			// the subtree under mid is one level higher than the one it replaced
+			node = mid;
+			while (node != header->parent())
+			{
+				NodePtr up = node->parent();
+				int balance = up->meta() + ((node == up->left) ? -1 : 1);
+
+				if (balance == 0)
+				{
+					up->set_meta(0);
+					return (top);
+				}
+				if (balance == 1 || balance == -1)
+				{
+					up->set_meta(balance);
+					node = up;
+					continue ;
+				}
+				node = fix(up, balance, header);
+				if (node->meta() == 0)
+					return (top);
+			}
+			return (top + 1);
+		}
+
+		// Walks up while the subtree on the given side of parent has shrunk
+		template < class NodePtr >
+		static void erase_rebalance(NodePtr node, NodePtr header)
+		{
+			unlinked<NodePtr> pos = unlink(node, header);
+			NodePtr parent = pos.parent;
+			bool left = pos.left;
+
+			while (parent != header)
+			{
+				int balance = parent->meta() + (left ? 1 : -1);
+
+				if (balance == 1 || balance == -1)
+				{
+					parent->set_meta(balance);
+					return ;
+				}
+				if (balance == 0)
+					parent->set_meta(0);
+				else
+				{
+					parent = fix(parent, balance, header);
+					if (parent->meta() != 0)
+						return ;
+				}
+				left = (parent->parent() != header && parent == parent->parent()->left);
+				parent = parent->parent();
+			}
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,609 @@
+#ifndef TREECONTAINER_HPP
+#define TREECONTAINER_HPP
+
+#include "utils.hpp"
+#include "iterators.hpp"
+#include "binarySearchTree.hpp"
+#include "pair.hpp"
+#include "nodePool.hpp"
+#include "nodeHandle.hpp"
+#include <memory>
+#include <functional>
+
+namespace ft
+{
+	// Sets only hand out const iterators: their values are their keys
+	template < class Tree, class KeyOf >
+	struct tree_iterator_of
+	{ typedef typename Tree::iterator type; };
+
+	template < class Tree, class T >
+	struct tree_iterator_of< Tree, ft::identity<T> >
+	{ typedef typename Tree::const_iterator type; };
+
+	// insert(value) gives (position, inserted) with unique keys, with equal
+	// keys it always inserts and only gives the position
+	template < class Keys, class Iterator >
+	struct tree_insert_result
+	{
+		typedef ft::pair<Iterator, bool> type;
+
+		template < class It >
+		static type make(const ft::pair<It, bool>& res)
+		{ return (type(res.first, res.second)); }
+	};
+
+	template < class Iterator >
+	struct tree_insert_result< ft::equal_keys, Iterator >
+	{
+		typedef Iterator type;
+
+		template < class It >
+		static type make(const ft::pair<It, bool>& res)
+		{ return (type(res.first)); }
+	};
+
+	/*
+	** What ft::map, ft::multimap, ft::set and ft::multiset have in common:
+	** one BST whose values give their key through KeyOf (ft::select_first
+	** or ft::identity), holding each key once or not (Keys = ft::unique_keys
+	** or ft::equal_keys). Derived is the container itself, which only adds
+	** its own types and its element access.
+	*/
+		template < class Derived, class Value, class KeyOf, class Keys,
+				class Compare, class Alloc, class Balance, class Augment >
+	class tree_container
+	{
+		public:
+
+			typedef typename KeyOf::key_type    key_type;
+
+			typedef Value   value_type;
+
+			typedef Compare     key_compare;
+
+			class value_compare : ft::binary_function<value_type, value_type, bool>
+			{
+				friend class tree_container;
+
+				protected:
+					Compare comp;
+					value_compare (Compare c) : comp(c) {}
+
+				public:
+
+					bool operator() (const value_type& x, const value_type& y) const
+					{ return (comp(KeyOf::key(x), KeyOf::key(y))); }
+			};
+
+			typedef Alloc  allocator_type;
+
+			typedef typename allocator_type::reference   reference;
+
+			typedef typename allocator_type::const_reference const_reference;
+
+			typedef typename allocator_type::pointer     pointer;
+
+			typedef typename allocator_type::const_pointer const_pointer;
+
+			/*
+			** Augment = ft::order_statistics makes every node count its
+			** subtree, enabling nth(), rank() and distance()
+			*/
+			typedef ft::node<value_type, Augment> node_type;
+
+			/*
+			** Nodes come from a slab pool fed by Alloc, see reserve().
+			** A pool is not thread safe, and neither are containers sharing one.
+			*/
+			typedef ft::node_pool<node_type, typename Alloc::template rebind<node_type>::other> node_allocator_type;
+
+			/*
+			** The underlying tree, Balance picks how it is kept shallow
+			** (ft::red_black_balance, ft::avl_balance or ft::no_balance)
+			*/
+			typedef ft::BST<value_type, key_compare, node_type, std::allocator<value_type>,
+				node_allocator_type, Balance, KeyOf, Keys> tree_type;
+
+			typedef typename ft::tree_iterator_of<tree_type, KeyOf>::type iterator;
+
+			typedef typename tree_type::const_iterator const_iterator;
+
+			typedef typename ft::reverse_iterator<iterator>    reverse_iterator;
+
+			typedef typename ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+			typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
+
+			typedef size_t size_type;
+
+			typedef typename ft::tree_insert_result<Keys, iterator>::type insert_result_type;
+
+			/*
+			** A node taken out by extract(), see insert(node_handle_type&&)
+			*/
+			typedef ft::node_handle<node_type, node_allocator_type, KeyOf> node_handle_type;
+
+			typedef ft::node_insert_return<iterator, node_handle_type> insert_return_type;
+
+
+			// Constructors
+
+			explicit tree_container (const key_compare& comp = key_compare(),
+				const allocator_type& alloc = allocator_type())
+			:
+				_alloc(alloc),
+				_comp(comp),
+				_bst(comp, node_allocator_type(alloc))
+			{}
+
+			// Containers built on one pool (see get_node_allocator()) hand their
+			// nodes over as they are in merge(), insert(node_handle_type&&),
+			// split() and join(). Only nodes move that way: values are copied
+			// and nodes allocated as soon as the pools differ.
+			explicit tree_container (const node_allocator_type& nodes,
+				const key_compare& comp = key_compare())
+			:
+				_alloc(nodes.upstream()),
+				_comp(comp),
+				_bst(comp, nodes)
+			{}
+
+			// Takes over the tree of x, which is left empty on a pool of its own
+			tree_container (tree_container&& x)
+			:
+				_alloc(x._alloc),
+				_comp(x._comp),
+				_bst(x._comp, node_allocator_type(x._alloc))
+			{ _bst.swap(x._bst); }
+
+
+			template <class InputIterator>
+				tree_container (InputIterator first, InputIterator last,
+					const key_compare& comp = key_compare(),
+					const allocator_type& alloc = allocator_type(),
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			:
+				_alloc(alloc),
+				_comp(comp),
+				_bst(comp, node_allocator_type(alloc))
+			{ this->insert(first, last); }
+
+
+			tree_container(const tree_container& x)
+			:
+				_alloc(x._alloc),
+				_comp(x._comp),
+				_bst(x._comp, node_allocator_type(x._alloc))
+			{ _bst.copy(x._bst); }
+
+
+			// Destructor
+
+			~tree_container()
+			{ this->clear(); }
+
+
+			// Operator=
+
+			tree_container& operator= (const tree_container& x)
+			{
+				if (&x == this)
+					return (*this);
+				_comp = x._comp;
+				_bst.copy(x._bst);
+				return (*this);
+			}
+
+
+			// Iterators
+
+			iterator begin()
+			{ return (iterator(_bst._last_node->left, _bst._last_node)); }
+
+			const_iterator begin() const
+			{ return (const_iterator(_bst._last_node->left, _bst._last_node)); }
+
+
+			iterator end()
+			{ return (iterator(_bst._last_node, _bst._last_node)); }
+
+			const_iterator end() const
+			{ return (const_iterator(_bst._last_node, _bst._last_node)); }
+
+
+			reverse_iterator rbegin()
+			{ return (reverse_iterator(this->end())); }
+
+			const_reverse_iterator rbegin() const
+			{ return (const_reverse_iterator(this->end())); }
+
+
+			reverse_iterator rend()
+			{ return (reverse_iterator(this->begin())); }
+
+			const_reverse_iterator rend() const
+			{ return (const_reverse_iterator(this->begin())); }
+
+
+			// Capacity
+
+			bool empty() const
+			{ return (_bst.size() == 0); }
+
+
+			size_type size() const
+			{ return (_bst.size()); }
+
+
+			size_type max_size() const
+			{ return (_bst.max_size()); }
+
+
+			// Pre-sizes the node pool so the next n insertions do not allocate
+			void reserve(size_type n)
+			{ _bst.reserve(n); }
+
+
+			// Modifiers
+
+			// With equal keys the value goes after its equals
+			insert_result_type insert (const value_type& val)
+			{ return (ft::tree_insert_result<Keys, iterator>::make(_bst.insertPair(val))); }
+
+			// As close to position as the order allows, like std::multimap
+			iterator insert (iterator position, const value_type& val)
+			{ return (_bst.insertHint(position.base(), val).first); }
+
+			template <class InputIterator>
+				void insert (InputIterator first, InputIterator last,
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			{
+				bool is_valid;
+				if (!(is_valid = ft::is_input_iterator_tagged<typename ft::iterator_traits<InputIterator>::iterator_category >::value))
+					return;
+				_bst.insertRange(first, last);
+			}
+
+
+			void erase (iterator position)
+			{ _bst.removeNode(position.base()); }
+
+			// Removes every value with key k
+			size_type erase (const key_type& k)
+			{ return (_bst.removeByKey(k)); }
+
+			void erase (iterator first, iterator last)
+			{
+				if (first == this->begin() && last == this->end())
+				{
+					this->clear();
+					return ;
+				}
+				while (first != last)
+					_bst.removeNode((first++).base());
+			}
+
+
+			// Node handles
+
+			// Unlinks the node at position, the handle owns it from now on
+			node_handle_type extract (iterator position)
+			{ return (node_handle_type(_bst.extractNode(position.base()), _bst._node_alloc)); }
+
+			// Empty handle when k is not there, else the first value with key k
+			node_handle_type extract (const key_type& k)
+			{
+				typename tree_type::node_pointer node = _find(k);
+
+				if (node == _bst._last_node)
+					return (node_handle_type());
+				return (node_handle_type(_bst.extractNode(node), _bst._node_alloc));
+			}
+
+			// Links the node of nh, which is left empty, unless its key is already
+			// there with unique keys: then nh is handed back in the result.
+			// Only a node from the same pool is linked as it is; any other is
+			// copied into this pool, and freed.
+			insert_return_type insert (node_handle_type&& nh)
+			{
+				insert_return_type res;
+
+				res.inserted = false;
+				if (nh.empty())
+				{
+					res.position = this->end();
+					return (res);
+				}
+
+				bool same_pool = (nh.get_allocator() == _bst._node_alloc);
+				ft::pair<typename tree_type::iterator, bool> found = same_pool
+					? _bst.insertNode(nh.node()) : _bst.insertPair(nh.value());
+
+				res.position = found.first;
+				res.inserted = found.second;
+				if (!found.second)
+					res.node = static_cast<node_handle_type&&>(nh);
+				else if (same_pool)
+					nh.release();
+				else
+					nh = node_handle_type();
+				return (res);
+			}
+
+			// Moves in the values of x whose key is not here yet (all of them
+			// with equal keys), the others stay in x. Nodes are relinked without
+			// allocating only when both containers share their pool.
+			void merge (Derived& x)
+			{ _bst.merge(x._bst); }
+
+
+			// Split and join, O(log n) on a balanced tree
+
+			// Moves the values whose key is not less than k into the returned
+			// container, which shares the node pool. O(log n) with Augment =
+			// ft::order_statistics; without it the sizes of both parts are not
+			// known and the smaller one is walked to count it: O(min(m, n - m))
+			// more, for m values moving out.
+			Derived split (const key_type& k)
+			{
+				Derived upper(_bst._node_alloc, _comp);
+
+				_bst.split(k, upper._bst);
+				return (upper);
+			}
+
+			// Takes every value of x when all its keys sort after (or all before)
+			// the keys here, leaving x empty: O(log n) when both containers
+			// share their pool. From another pool x is first cloned into this
+			// one in a single pass, without comparing keys: O(size of x) more.
+			// Interleaved keys come down to merge().
+			void join (Derived& x)
+			{
+				if (static_cast<tree_container*>(&x) == this || x.empty())
+					return ;
+
+				bool after = this->empty() || _comp(_key(_bst._last_node->right), _key(x._bst._last_node->left));
+				if (!after && !_comp(_key(x._bst._last_node->right), _key(_bst._last_node->left)))
+				{
+					this->merge(x);
+					return ;
+				}
+				if (_bst._node_alloc == x._bst._node_alloc)
+				{
+					_join(x._bst, after);
+					return ;
+				}
+				tree_type nodes(_comp, _bst._node_alloc);
+				nodes.copy(x._bst);
+				x.clear();
+				_join(nodes, after);
+			}
+
+
+			void swap (Derived& x)
+			{
+				_bst.swap(x._bst);
+
+				key_compare save_comp = _comp;
+				_comp = x._comp;
+				x._comp = save_comp;
+			}
+
+
+			void clear()
+			{ _bst.clear(); }
+
+
+			// Observers
+
+			key_compare key_comp() const
+			{ return (_comp); }
+
+
+			value_compare value_comp() const
+			{ return (value_compare(_comp)); }
+
+
+			// Operations
+
+			// With equal keys, the first value with key k
+			iterator find (const key_type& k)
+			{ return (iterator(_find(k), _bst._last_node)); }
+
+			const_iterator find (const key_type& k) const
+			{ return (const_iterator(_find(k), _bst._last_node)); }
+
+			// Heterogeneous lookups, only with a comparator declaring is_transparent
+			template <class K>
+				iterator find (const K& x,
+				typename ft::enable_if<ft::is_transparent<Compare>::value, K>::type* = nullptr)
+			{ return (iterator(_find(x), _bst._last_node)); }
+
+			template <class K>
+				const_iterator find (const K& x,
+				typename ft::enable_if<ft::is_transparent<Compare>::value, K>::type* = nullptr) const
+			{ return (const_iterator(_find(x), _bst._last_node)); }
+
+
+			size_type count (const key_type& k) const
+			{ return (_count(k)); }
+
+			template <class K>
+				size_type count (const K& x,
+				typename ft::enable_if<ft::is_transparent<Compare>::value, K>::type* = nullptr) const
+			{ return (_count(x)); }
+
+
+			iterator lower_bound (const key_type& k)
+			{ return (iterator(_bst.lowerBound(k), _bst._last_node)); }
+
+			const_iterator lower_bound (const key_type& k) const
+			{ return (const_iterator(_bst.lowerBound(k), _bst._last_node)); }
+
+
+			iterator upper_bound (const key_type& k)
+			{ return (iterator(_bst.upperBound(k), _bst._last_node)); }
+
+			const_iterator upper_bound (const key_type& k) const
+			{ return (const_iterator(_bst.upperBound(k), _bst._last_node)); }
+
+
+			ft::pair<const_iterator, const_iterator> equal_range (const key_type& k) const
+			{
+				ft::pair<typename tree_type::node_pointer, typename tree_type::node_pointer> range = _bst.equalRange(k);
+				return (ft::make_pair(const_iterator(range.first, _bst._last_node),
+					const_iterator(range.second, _bst._last_node)));
+			}
+
+			ft::pair<iterator, iterator> equal_range (const key_type& k)
+			{
+				ft::pair<typename tree_type::node_pointer, typename tree_type::node_pointer> range = _bst.equalRange(k);
+				return (ft::make_pair(iterator(range.first, _bst._last_node),
+					iterator(range.second, _bst._last_node)));
+			}
+
+			// Set operations by key, one lockstep pass over both containers
+			// whose result is linked into a balanced tree as it comes: O(n + m).
+			// A key in both keeps the value it has here.
+
+			Derived set_union (const Derived& x) const
+			{
+				Derived res(_comp, _alloc);
+
+				ft::set_union(this->begin(), this->end(), x.begin(), x.end(),
+					res._bst.appender(), this->value_comp());
+				res._bst.buildAppended();
+				return (res);
+			}
+
+			Derived set_intersection (const Derived& x) const
+			{
+				Derived res(_comp, _alloc);
+
+				ft::set_intersection(this->begin(), this->end(), x.begin(), x.end(),
+					res._bst.appender(), this->value_comp());
+				res._bst.buildAppended();
+				return (res);
+			}
+
+			Derived set_difference (const Derived& x) const
+			{
+				Derived res(_comp, _alloc);
+
+				ft::set_difference(this->begin(), this->end(), x.begin(), x.end(),
+					res._bst.appender(), this->value_comp());
+				res._bst.buildAppended();
+				return (res);
+			}
+
+			// Order statistics, only with Augment = ft::order_statistics: on any
+			// other container these fail to compile
+
+			// Element at position n, end() if n >= size()
+			iterator nth (size_type n)
+			{ return (iterator(_bst.select(n), _bst._last_node)); }
+
+			const_iterator nth (size_type n) const
+			{ return (const_iterator(_bst.select(n), _bst._last_node)); }
+
+			// Number of keys less than k
+			size_type rank (const key_type& k) const
+			{ return (_bst.rank(k)); }
+
+			// std::distance(first, last) in O(log n)
+			difference_type distance (const_iterator first, const_iterator last) const
+			{
+				return (static_cast<difference_type>(_bst.indexOf(last.base()))
+					- static_cast<difference_type>(_bst.indexOf(first.base())));
+			}
+
+			// Allocator:
+			allocator_type get_allocator() const { return _alloc; }
+
+			node_allocator_type get_node_allocator() const { return (_bst._node_alloc); }
+
+		protected:
+
+			allocator_type                          _alloc;
+			Compare                                 _comp;
+			tree_type                               _bst;
+
+			static const key_type& _key(typename tree_type::node_pointer node)
+			{ return (KeyOf::key(node->value)); }
+
+			// Links tree, on the same pool, after (or before) the values here
+			void _join(tree_type& tree, bool after)
+			{
+				if (after)
+					_bst.join(tree);
+				else
+				{
+					tree.join(_bst);
+					_bst.swap(tree);
+				}
+			}
+
+			// With equal keys searchByKey() may stop on any of them
+			template < class K >
+			typename tree_type::node_pointer _find(const K& k) const
+			{
+				if (Keys::unique)
+					return (_bst.searchByKey(k));
+
+				typename tree_type::node_pointer node = _bst.lowerBound(k);
+				if (node == _bst._last_node || _comp(k, _key(node)))
+					return (_bst._last_node);
+				return (node);
+			}
+
+			template < class K >
+			size_type _count(const K& k) const
+			{
+				if (Keys::unique)
+					return (_bst.searchByKey(k) != _bst._last_node);
+
+				ft::pair<typename tree_type::node_pointer, typename tree_type::node_pointer> range = _bst.equalRange(k);
+				return (ft::distance(const_iterator(range.first, _bst._last_node),
+					const_iterator(range.second, _bst._last_node)));
+			}
+
+	};
+
+	template < class D, class V, class KO, class KP, class C, class A, class B, class AU >
+	bool operator== (const tree_container<D, V, KO, KP, C, A, B, AU>& lhs,
+		const tree_container<D, V, KO, KP, C, A, B, AU>& rhs)
+	{
+		if (lhs.size() != rhs.size())
+			return (false);
+		return (ft::equal(lhs.begin(), lhs.end(), rhs.begin()));
+	}
+
+	template < class D, class V, class KO, class KP, class C, class A, class B, class AU >
+	bool operator!= (const tree_container<D, V, KO, KP, C, A, B, AU>& lhs,
+		const tree_container<D, V, KO, KP, C, A, B, AU>& rhs)
+	{ return (!(lhs == rhs)); }
+
+	template < class D, class V, class KO, class KP, class C, class A, class B, class AU >
+	bool operator< (const tree_container<D, V, KO, KP, C, A, B, AU>& lhs,
+		const tree_container<D, V, KO, KP, C, A, B, AU>& rhs)
+	{ return (ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end())); }
+
+	template < class D, class V, class KO, class KP, class C, class A, class B, class AU >
+	bool operator> (const tree_container<D, V, KO, KP, C, A, B, AU>& lhs,
+		const tree_container<D, V, KO, KP, C, A, B, AU>& rhs)
+	{ return (rhs < lhs); }
+
+	template < class D, class V, class KO, class KP, class C, class A, class B, class AU >
+	bool operator<= (const tree_container<D, V, KO, KP, C, A, B, AU>& lhs,
+		const tree_container<D, V, KO, KP, C, A, B, AU>& rhs)
+	{ return (!(rhs < lhs)); }
+
+	template < class D, class V, class KO, class KP, class C, class A, class B, class AU >
+	bool operator>= (const tree_container<D, V, KO, KP, C, A, B, AU>& lhs,
+		const tree_container<D, V, KO, KP, C, A, B, AU>& rhs)
+	{ return (!(lhs < rhs)); }
+
+}
+
+#endif
@@ -0,0 +1,783 @@
+#ifndef UNORDEREDMAP_HPP
+#define UNORDEREDMAP_HPP
+
+#include "utils.hpp"
+#include "iterators.hpp"
+#include "pair.hpp"
+#include <memory>
+#include <functional>
+#include <new>
+
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+namespace ft
+{
+	/*
+	** Control bytes, one per slot: a full slot stores the 7 low bits of its
+	** hash (0 to 127), the others are negative. The sentinel closes the
+	** array so that iterators stop at end() without knowing the capacity.
+	*/
+	enum hash_ctrl
+	{
+		ctrl_empty = -128,
+		ctrl_deleted = -2,
+		ctrl_sentinel = -1
+	};
+
+	/*
+	** 16 control bytes matched at once: every match returns a bit mask,
+	** bit i set when byte i matches
+	*/
+	struct hash_group
+	{
+		static const size_t width = 16;
+
+#ifdef __SSE2__
+		__m128i ctrl;
+
+		explicit hash_group(const signed char* pos)
+		: ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)))
+		{}
+
+		unsigned match(signed char h2) const
+		{ return (_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)))); }
+
+		unsigned match_empty() const
+		{ return (match(static_cast<signed char>(ctrl_empty))); }
+
+		// empty or deleted
+		unsigned match_free() const
+		{ return (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), ctrl))); }
+#else
+		const signed char* ctrl;
+
+		explicit hash_group(const signed char* pos) : ctrl(pos) {}
+
+		unsigned match(signed char h2) const
+		{
+			unsigned mask = 0;
+			for (size_t i = 0; i < width; ++i)
+				if (ctrl[i] == h2)
+					mask |= 1u << i;
+			return (mask);
+		}
+
+		unsigned match_empty() const
+		{ return (match(static_cast<signed char>(ctrl_empty))); }
+
+		unsigned match_free() const
+		{
+			unsigned mask = 0;
+			for (size_t i = 0; i < width; ++i)
+				if (ctrl[i] < ctrl_sentinel)
+					mask |= 1u << i;
+			return (mask);
+		}
+#endif
+
+		static size_t lowest(unsigned mask)
+		{ return (__builtin_ctz(mask)); }
+	};
+
+	/*
+	** Forward iterators walk the control bytes and the slots side by side,
+	** skipping the free slots up to the sentinel
+	*/
+	template < class Value >
+	class hash_iterator : ft::iterator< ft::forward_iterator_tag, Value >
+	{
+		public :
+			typedef Value value_type;
+			typedef typename ft::iterator<ft::forward_iterator_tag, value_type>::iterator_category iterator_category;
+			typedef typename ft::iterator<ft::forward_iterator_tag, value_type>::difference_type   difference_type;
+			typedef typename ft::iterator<ft::forward_iterator_tag, value_type>::pointer   pointer;
+			typedef typename ft::iterator<ft::forward_iterator_tag, value_type>::reference reference;
+
+			hash_iterator() : _ctrl(), _slot() {}
+
+			hash_iterator(signed char* ctrl, value_type* slot) : _ctrl(ctrl), _slot(slot) {}
+
+			hash_iterator(const hash_iterator& it) : _ctrl(it._ctrl), _slot(it._slot) {}
+
+			~hash_iterator() {}
+
+			hash_iterator &operator=(const hash_iterator& it)
+			{
+				this->_ctrl = it._ctrl;
+				this->_slot = it._slot;
+				return (*this);
+			}
+
+			signed char* ctrl() const
+			{ return (this->_ctrl); }
+
+			value_type* base() const
+			{ return (this->_slot); }
+
+			bool operator==(const hash_iterator& it) const
+			{ return (this->_slot == it._slot); }
+
+			bool operator!=(const hash_iterator& it) const
+			{ return (this->_slot != it._slot); }
+
+			reference operator*() const
+			{ return (*this->_slot); }
+
+			pointer operator->() const
+			{ return (this->_slot); }
+
+			hash_iterator& operator++(void)
+			{
+				++_ctrl;
+				++_slot;
+				while (*_ctrl < ctrl_sentinel)
+				{
+					++_ctrl;
+					++_slot;
+				}
+				return (*this);
+			}
+
+			hash_iterator operator++(int)
+			{
+				hash_iterator tmp(*this);
+				operator++();
+				return (tmp);
+			}
+
+		private :
+			signed char*    _ctrl;
+			value_type*     _slot;
+	};
+
+	template < class Value >
+	class hash_const_iterator : ft::iterator< ft::forward_iterator_tag, Value >
+	{
+		public :
+			typedef Value value_type;
+			typedef typename ft::iterator<ft::forward_iterator_tag, value_type>::iterator_category iterator_category;
+			typedef typename ft::iterator<ft::forward_iterator_tag, value_type>::difference_type   difference_type;
+			typedef const value_type*   pointer;
+			typedef const value_type&   reference;
+
+			hash_const_iterator() : _ctrl(), _slot() {}
+
+			hash_const_iterator(signed char* ctrl, value_type* slot) : _ctrl(ctrl), _slot(slot) {}
+
+			hash_const_iterator(const hash_const_iterator& it) : _ctrl(it._ctrl), _slot(it._slot) {}
+
+			hash_const_iterator(const hash_iterator<Value>& it) : _ctrl(it.ctrl()), _slot(it.base()) {}
+
+			~hash_const_iterator() {}
+
+			hash_const_iterator &operator=(const hash_const_iterator& it)
+			{
+				this->_ctrl = it._ctrl;
+				this->_slot = it._slot;
+				return (*this);
+			}
+
+			signed char* ctrl() const
+			{ return (this->_ctrl); }
+
+			value_type* base() const
+			{ return (this->_slot); }
+
+			bool operator==(const hash_const_iterator& it) const
+			{ return (this->_slot == it._slot); }
+
+			bool operator!=(const hash_const_iterator& it) const
+			{ return (this->_slot != it._slot); }
+
+			reference operator*() const
+			{ return (*this->_slot); }
+
+			pointer operator->() const
+			{ return (this->_slot); }
+
+			hash_const_iterator& operator++(void)
+			{
+				++_ctrl;
+				++_slot;
+				while (*_ctrl < ctrl_sentinel)
+				{
+					++_ctrl;
+					++_slot;
+				}
+				return (*this);
+			}
+
+			hash_const_iterator operator++(int)
+			{
+				hash_const_iterator tmp(*this);
+				operator++();
+				return (tmp);
+			}
+
+		private :
+			signed char*    _ctrl;
+			value_type*     _slot;
+	};
+
+	/*
+	** Open addressing hash map. Slots come by groups of 16 with one control
+	** byte each; a lookup hashes the key once, then per probed group compares
+	** the 16 control bytes with the 7 hash bits it carries (SSE2 when
+	** available) and only compares keys on a match. Probing stops at the
+	** first group holding an empty slot.
+	** Groups are probed in triangular order, which visits every group of a
+	** power of two table. Values never move outside of a rehash: erase only
+	** invalidates iterators to the erased value, insert may rehash.
+	*/
+	template < class Key, class T, class Hash = std::hash<Key>, class Pred = std::equal_to<Key>,
+			class Alloc = std::allocator<ft::pair<const Key, T> > >
+	class unordered_map
+	{
+		public:
+
+			typedef Key     key_type;
+
+			typedef T       mapped_type;
+
+			typedef ft::pair<key_type, mapped_type> value_type;
+
+			typedef Hash    hasher;
+
+			typedef Pred    key_equal;
+
+			typedef Alloc  allocator_type;
+
+			typedef typename allocator_type::reference   reference;
+
+			typedef typename allocator_type::const_reference const_reference;
+
+			typedef typename allocator_type::pointer     pointer;
+
+			typedef typename allocator_type::const_pointer const_pointer;
+
+			typedef ft::hash_iterator<value_type> iterator;
+
+			typedef ft::hash_const_iterator<value_type> const_iterator;
+
+			typedef typename ft::iterator_traits<iterator>::difference_type difference_type;
+
+			typedef size_t size_type;
+
+
+			// Constructors
+
+			explicit unordered_map (size_type n = 0, const hasher& hf = hasher(),
+				const key_equal& eql = key_equal(), const allocator_type& alloc = allocator_type())
+			:
+				_alloc(alloc),
+				_hash(hf),
+				_eq(eql),
+				_max_load(0.875f)
+			{
+				_reset();
+				if (n != 0)
+					this->rehash(n);
+			}
+
+
+			template <class InputIterator>
+				unordered_map (InputIterator first, InputIterator last, size_type n = 0,
+					const hasher& hf = hasher(), const key_equal& eql = key_equal(),
+					const allocator_type& alloc = allocator_type(),
+					typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			:
+				_alloc(alloc),
+				_hash(hf),
+				_eq(eql),
+				_max_load(0.875f)
+			{
+				_reset();
+				if (n != 0)
+					this->rehash(n);
+				this->insert(first, last);
+			}
+
+
+			// Same layout, so every value is copied into the same slot
+			unordered_map(const unordered_map& x)
+			:
+				_alloc(x._alloc),
+				_hash(x._hash),
+				_eq(x._eq),
+				_max_load(x._max_load)
+			{
+				_reset();
+				if (x._capacity == 0)
+					return ;
+				_allocate(x._capacity);
+				for (size_type i = 0; i < _capacity; ++i)
+				{
+					_ctrl[i] = x._ctrl[i];
+					if (_ctrl[i] >= 0)
+						new (static_cast<void*>(_slots + i)) value_type(x._slots[i]);
+				}
+				_size = x._size;
+				_deleted = x._deleted;
+			}
+
+
+			// Destructor
+
+			~unordered_map()
+			{ _release(); }
+
+
+			// Operator=
+
+			unordered_map& operator= (const unordered_map& x)
+			{
+				if (&x == this)
+					return (*this);
+				unordered_map tmp(x);
+				this->swap(tmp);
+				return (*this);
+			}
+
+
+			// Iterators
+
+			iterator begin()
+			{ return (_begin<iterator>()); }
+
+			const_iterator begin() const
+			{ return (_begin<const_iterator>()); }
+
+
+			iterator end()
+			{ return (iterator(_ctrl + _capacity, _slots + _capacity)); }
+
+			const_iterator end() const
+			{ return (const_iterator(_ctrl + _capacity, _slots + _capacity)); }
+
+
+			// Capacity
+
+			bool empty() const
+			{ return (_size == 0); }
+
+
+			size_type size() const
+			{ return (_size); }
+
+
+			size_type max_size() const
+			{ return (_slot_alloc().max_size()); }
+
+
+			// Element access
+
+			mapped_type& operator[] (const key_type& k)
+			{
+				size_type hash = _hashOf(k);
+				size_type slot = _find(k, hash);
+
+				if (slot == _capacity)
+				{
+					slot = _prepareInsert(hash);
+					new (static_cast<void*>(_slots + slot)) value_type(k, mapped_type());
+					_claim(slot, hash);
+				}
+				return (_slots[slot].second);
+			}
+
+
+			// Modifiers
+
+			pair<iterator,bool> insert (const value_type& val)
+			{
+				size_type hash = _hashOf(val.first);
+				size_type slot = _find(val.first, hash);
+
+				if (slot != _capacity)
+					return (ft::make_pair(_at(slot), false));
+				slot = _prepareInsert(hash);
+				new (static_cast<void*>(_slots + slot)) value_type(val);
+				_claim(slot, hash);
+				return (ft::make_pair(_at(slot), true));
+			}
+
+			iterator insert (const_iterator hint, const value_type& val)
+			{
+				(void)hint;
+				return (this->insert(val).first);
+			}
+
+			template <class InputIterator>
+				void insert (InputIterator first, InputIterator last,
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
+			{
+				for (; first != last; ++first)
+					this->insert(*first);
+			}
+
+
+			void erase (const_iterator position)
+			{ _eraseSlot(position.base() - _slots); }
+
+			size_type erase (const key_type& k)
+			{
+				size_type slot = _find(k, _hashOf(k));
+
+				if (slot == _capacity)
+					return (0);
+				_eraseSlot(slot);
+				return (1);
+			}
+
+			void erase (const_iterator first, const_iterator last)
+			{
+				while (first != last)
+					this->erase(first++);
+			}
+
+
+			void swap (unordered_map& x)
+			{
+				_swap(_alloc, x._alloc);
+				_swap(_hash, x._hash);
+				_swap(_eq, x._eq);
+				_swap(_max_load, x._max_load);
+				_swap(_ctrl, x._ctrl);
+				_swap(_slots, x._slots);
+				_swap(_capacity, x._capacity);
+				_swap(_size, x._size);
+				_swap(_deleted, x._deleted);
+				_swap(_growth_limit, x._growth_limit);
+			}
+
+
+			// Keeps the slots, see rehash() to give them back
+			void clear()
+			{
+				for (size_type i = 0; i < _capacity; ++i)
+				{
+					if (_ctrl[i] >= 0)
+						_slots[i].~value_type();
+					_ctrl[i] = ctrl_empty;
+				}
+				_size = 0;
+				_deleted = 0;
+			}
+
+
+			// Lookup
+
+			iterator find (const key_type& k)
+			{ return (_at(_find(k, _hashOf(k)))); }
+
+			const_iterator find (const key_type& k) const
+			{
+				size_type slot = _find(k, _hashOf(k));
+				return (const_iterator(_ctrl + slot, _slots + slot));
+			}
+
+
+			size_type count (const key_type& k) const
+			{ return (_find(k, _hashOf(k)) != _capacity); }
+
+
+			ft::pair<iterator, iterator> equal_range (const key_type& k)
+			{
+				iterator it = this->find(k);
+
+				if (it == this->end())
+					return (ft::make_pair(it, it));
+				iterator next = it;
+				return (ft::make_pair(it, ++next));
+			}
+
+			ft::pair<const_iterator, const_iterator> equal_range (const key_type& k) const
+			{
+				const_iterator it = this->find(k);
+
+				if (it == this->end())
+					return (ft::make_pair(it, it));
+				const_iterator next = it;
+				return (ft::make_pair(it, ++next));
+			}
+
+
+			// Hash policy
+
+			// Every slot counts as a bucket
+			size_type bucket_count() const
+			{ return (_capacity); }
+
+
+			float load_factor() const
+			{ return (_capacity == 0 ? 0.0f : static_cast<float>(_size) / _capacity); }
+
+
+			float max_load_factor() const
+			{ return (_max_load); }
+
+			// Capped at 15/16 so that every probe finds an empty slot
+			void max_load_factor(float ml)
+			{
+				if (ml <= 0.0f)
+					return ;
+				_max_load = (ml > 0.9375f) ? 0.9375f : ml;
+				_growth_limit = _limitFor(_capacity);
+				if (_size + _deleted > _growth_limit)
+					this->rehash(0);
+			}
+
+
+			// At least n slots and room for size() values, tombstones are dropped
+			void rehash(size_type n)
+			{
+				size_type capacity = _capacityFor(_size);
+
+				while (capacity < n)
+					capacity *= 2;
+				if (capacity == _capacity && _deleted == 0)
+					return ;
+				_resize(capacity);
+			}
+
+
+			// Room for n values without rehashing
+			void reserve(size_type n)
+			{
+				if (n > _growth_limit)
+					_resize(_capacityFor(n));
+			}
+
+
+			// Observers
+
+			hasher hash_function() const
+			{ return (_hash); }
+
+
+			key_equal key_eq() const
+			{ return (_eq); }
+
+
+			// Allocator:
+			allocator_type get_allocator() const { return _alloc; }
+
+		private:
+
+			typedef typename Alloc::template rebind<value_type>::other slot_alloc;
+
+			typedef typename Alloc::template rebind<signed char>::other ctrl_alloc;
+
+			allocator_type                          _alloc;
+			hasher                                  _hash;
+			key_equal                               _eq;
+			float                                   _max_load;
+			signed char*                            _ctrl;
+			value_type*                             _slots;
+			size_type                               _capacity;
+			size_type                               _size;
+			size_type                               _deleted;
+			size_type                               _growth_limit;
+
+			template < class U >
+			static void _swap(U& a, U& b)
+			{
+				U tmp = a;
+				a = b;
+				b = tmp;
+			}
+
+			slot_alloc _slot_alloc() const
+			{ return (slot_alloc(_alloc)); }
+
+			void _reset()
+			{
+				_ctrl = nullptr;
+				_slots = nullptr;
+				_capacity = 0;
+				_size = 0;
+				_deleted = 0;
+				_growth_limit = 0;
+			}
+
+			// Spreads the user hash: its low bits pick the group, the
+			// 7 bits kept in the control byte must differ within a group
+			size_type _hashOf(const key_type& k) const
+			{
+				size_type hash = _hash(k) * static_cast<size_type>(0x9E3779B97F4A7C15ULL);
+				return (hash ^ (hash >> (sizeof(size_type) * 4)));
+			}
+
+			static signed char _h2(size_type hash)
+			{ return (static_cast<signed char>(hash & 0x7F)); }
+
+			size_type _groupMask() const
+			{ return (_capacity / hash_group::width - 1); }
+
+			size_type _limitFor(size_type capacity) const
+			{ return (static_cast<size_type>(capacity * _max_load)); }
+
+			// Smallest power of two table (16 slots at least) holding n values
+			size_type _capacityFor(size_type n) const
+			{
+				size_type capacity = hash_group::width;
+
+				while (_limitFor(capacity) < n)
+					capacity *= 2;
+				return (capacity);
+			}
+
+			iterator _at(size_type slot)
+			{ return (iterator(_ctrl + slot, _slots + slot)); }
+
+			template < class It >
+			It _begin() const
+			{
+				if (_capacity == 0)
+					return (It(_ctrl, _slots));
+
+				size_type i = 0;
+				while (_ctrl[i] < ctrl_sentinel)
+					++i;
+				return (It(_ctrl + i, _slots + i));
+			}
+
+			// Slot holding k, _capacity when there is none
+			size_type _find(const key_type& k, size_type hash) const
+			{
+				if (_capacity == 0)
+					return (0);
+
+				size_type mask = _groupMask();
+				size_type group = (hash >> 7) & mask;
+				signed char h2 = _h2(hash);
+
+				for (size_type step = 1; ; ++step)
+				{
+					size_type first = group * hash_group::width;
+					hash_group g(_ctrl + first);
+
+					for (unsigned match = g.match(h2); match != 0; match &= match - 1)
+					{
+						size_type slot = first + hash_group::lowest(match);
+						if (_eq(_slots[slot].first, k))
+							return (slot);
+					}
+					if (g.match_empty() != 0)
+						return (_capacity);
+					group = (group + step) & mask;
+				}
+			}
+
+			// First free slot on the probe path of hash, in a table with room
+			size_type _findFree(size_type hash) const
+			{
+				size_type mask = _groupMask();
+				size_type group = (hash >> 7) & mask;
+
+				for (size_type step = 1; ; ++step)
+				{
+					size_type first = group * hash_group::width;
+					unsigned match = hash_group(_ctrl + first).match_free();
+
+					if (match != 0)
+						return (first + hash_group::lowest(match));
+					group = (group + step) & mask;
+				}
+			}
+
+			// Free slot for a new value with this hash, growing first if the
+			// table is too loaded; the caller constructs the value there and
+			// only then claims the slot with _claim(), so that a throwing
+			// constructor leaves the table as it was
+			size_type _prepareInsert(size_type hash)
+			{
+				if (_size + _deleted + 1 > _growth_limit)
+					_resize(_capacityFor(_size + 1));
+				return (_findFree(hash));
+			}
+
+			void _claim(size_type slot, size_type hash)
+			{
+				if (_ctrl[slot] == ctrl_deleted)
+					_deleted -= 1;
+				_ctrl[slot] = _h2(hash);
+				_size += 1;
+			}
+
+			// A group that still has an empty slot never made a probe go
+			// further, so the slot can be empty again; otherwise a tombstone
+			// keeps the probe paths crossing this group alive
+			void _eraseSlot(size_type slot)
+			{
+				size_type first = slot - slot % hash_group::width;
+
+				_slots[slot].~value_type();
+				if (hash_group(_ctrl + first).match_empty() != 0)
+					_ctrl[slot] = ctrl_empty;
+				else
+				{
+					_ctrl[slot] = ctrl_deleted;
+					_deleted += 1;
+				}
+				_size -= 1;
+			}
+
+			void _allocate(size_type capacity)
+			{
+				ctrl_alloc ctrl(_alloc);
+
+				_ctrl = ctrl.allocate(capacity + 1);
+				for (size_type i = 0; i < capacity; ++i)
+					_ctrl[i] = ctrl_empty;
+				_ctrl[capacity] = ctrl_sentinel;
+				_slots = _slot_alloc().allocate(capacity);
+				_capacity = capacity;
+				_growth_limit = _limitFor(capacity);
+			}
+
+			void _deallocate(signed char* ctrl, value_type* slots, size_type capacity)
+			{
+				if (ctrl == nullptr)
+					return ;
+				ctrl_alloc(_alloc).deallocate(ctrl, capacity + 1);
+				_slot_alloc().deallocate(slots, capacity);
+			}
+
+			void _release()
+			{
+				for (size_type i = 0; i < _capacity; ++i)
+					if (_ctrl[i] >= 0)
+						_slots[i].~value_type();
+				_deallocate(_ctrl, _slots, _capacity);
+				_reset();
+			}
+
+			// Moves every value to a fresh table of the given capacity
+			void _resize(size_type capacity)
+			{
+				signed char* old_ctrl = _ctrl;
+				value_type* old_slots = _slots;
+				size_type old_capacity = _capacity;
+
+				_allocate(capacity);
+				_deleted = 0;
+				for (size_type i = 0; i < old_capacity; ++i)
+				{
+					if (old_ctrl[i] < 0)
+						continue ;
+					size_type hash = _hashOf(old_slots[i].first);
+					size_type slot = _findFree(hash);
+					_ctrl[slot] = _h2(hash);
+					new (static_cast<void*>(_slots + slot)) value_type(old_slots[i]);
+					old_slots[i].~value_type();
+				}
+				_deallocate(old_ctrl, old_slots, old_capacity);
+			}
+	};
+
+}
+
+#endif
@@ -73,6 +73,102 @@ namespace ft
 		return false;
 	}
 
+	/*
+	** set_union, set_intersection, set_difference: one lockstep pass over
+	** two ranges sorted by comp, O(n + m). On equivalent elements the one
+	** of the first range is written.
+	*/
+	template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+	OutputIterator set_union (InputIterator1 first1, InputIterator1 last1,
+								InputIterator2 first2, InputIterator2 last2,
+								OutputIterator result, Compare comp)
+	{
+		for (; first1 != last1 && first2 != last2; ++result)
+		{
+			if (comp(*first2, *first1))
+				*result = *first2++;
+			else
+			{
+				if (!comp(*first1, *first2))
+					++first2;
+				*result = *first1++;
+			}
+		}
+		for (; first1 != last1; ++first1, ++result)
+			*result = *first1;
+		for (; first2 != last2; ++first2, ++result)
+			*result = *first2;
+		return (result);
+	}
+
+	template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+	OutputIterator set_intersection (InputIterator1 first1, InputIterator1 last1,
+								InputIterator2 first2, InputIterator2 last2,
+								OutputIterator result, Compare comp)
+	{
+		while (first1 != last1 && first2 != last2)
+		{
+			if (comp(*first1, *first2))
+				++first1;
+			else if (comp(*first2, *first1))
+				++first2;
+			else
+			{
+				*result = *first1++;
+				++first2;
+				++result;
+			}
+		}
+		return (result);
+	}
+
+	template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+	OutputIterator set_difference (InputIterator1 first1, InputIterator1 last1,
+								InputIterator2 first2, InputIterator2 last2,
+								OutputIterator result, Compare comp)
+	{
+		while (first1 != last1 && first2 != last2)
+		{
+			if (comp(*first1, *first2))
+			{
+				*result = *first1++;
+				++result;
+			}
+			else
+			{
+				if (!comp(*first2, *first1))
+					++first1;
+				++first2;
+			}
+		}
+		for (; first1 != last1; ++first1, ++result)
+			*result = *first1;
+		return (result);
+	}
+
+	// Same with operator<
+	struct less_than
+	{
+		template <class T1, class T2>
+		bool operator() (const T1& a, const T2& b) const
+		{ return (a < b); }
+	};
+
+	template <class InputIterator1, class InputIterator2, class OutputIterator>
+	OutputIterator set_union (InputIterator1 first1, InputIterator1 last1,
+								InputIterator2 first2, InputIterator2 last2, OutputIterator result)
+	{ return (ft::set_union(first1, last1, first2, last2, result, less_than())); }
+
+	template <class InputIterator1, class InputIterator2, class OutputIterator>
+	OutputIterator set_intersection (InputIterator1 first1, InputIterator1 last1,
+								InputIterator2 first2, InputIterator2 last2, OutputIterator result)
+	{ return (ft::set_intersection(first1, last1, first2, last2, result, less_than())); }
+
+	template <class InputIterator1, class InputIterator2, class OutputIterator>
+	OutputIterator set_difference (InputIterator1 first1, InputIterator1 last1,
+								InputIterator2 first2, InputIterator2 last2, OutputIterator result)
+	{ return (ft::set_difference(first1, last1, first2, last2, result, less_than())); }
+
 	/* Distance between pointers */
 	template < class InputIterator >
 	int	distnce(InputIterator start, InputIterator end)
@@ -86,11 +182,37 @@ namespace ft
 	}
 
 
+	/* Our binary_function, std::binary_function is deprecated since C++11 */
+	template < class Arg1, class Arg2, class Result >
+	struct binary_function
+	{
+		typedef Arg1    first_argument_type;
+		typedef Arg2    second_argument_type;
+		typedef Result  result_type;
+	};
+
+
 	/* Our enable_if */
 	template < bool Cond, class T > struct enable_if{};
 	template < class T > struct enable_if< true, T > { typedef T type; };
 
 
+	/* Detects a comparator declaring is_transparent (heterogeneous lookup) */
+	template < class Compare >
+		struct is_transparent
+		{
+			private:
+				typedef char yes;
+				typedef struct { char c[2]; } no;
+
+				template < class U > static yes test(typename U::is_transparent*);
+				template < class U > static no test(...);
+
+			public:
+				static const bool value = (sizeof(test<Compare>(nullptr)) == sizeof(yes));
+		};
+
+
 	/* IsIntegral condition */
 	template < bool isIntegral, typename T >
 		struct is_integral_res {
@@ -114,9 +114,9 @@ namespace ft
 				while (n--)
 				{
 					_alloc.construct(_end, val);
-					_end++;
+					if (n)
+						_end++;
 				}
-				_end--;
 			}
 
 			template < class InputIterator >
@@ -134,29 +134,33 @@ namespace ft
 				{
 					_alloc.construct(_end, *first);
 					first++;
-					_end++;
+					if (n)
+						_end++;
 				}
-				_end--;
 			}
 			
-			vector(const vector& x) { *this = x; }
+			vector(const vector& x) :
+			_alloc(x._alloc), start(nullptr), _end(nullptr), _size(0), _capacity(0)
+			{ *this = x; }
 
 			// Operators :
 
 			const vector & operator=(const vector& x)
 			{
+				if (&x == this)
+					return *this;
+				vclean(_alloc, start);
 				_alloc = x._alloc;
 				_size = x._size;
 				_capacity = x._capacity;
-				start = this->_alloc.allocate( _capacity + 1 );
+				start = (_capacity == 0) ? nullptr : this->_alloc.allocate( _capacity );
 				_end = start;
 				for( const_iterator it = x.begin(); it != x.end(); it++)
 				{
-					
+					if (it != x.begin())
+						_end++;
 					_alloc.construct(_end, *it);
-					_end++;
 				}
-				_end--;
 				return *this;
 			}
 
@@ -165,34 +169,17 @@ namespace ft
 				~vector()
 				{
 					for (; _size > 0; _size--)
-					{
-						_alloc.destroy(_end);
-						_end--;
-					}
+						_alloc.destroy(start + _size - 1);
 					_alloc.deallocate(start, _capacity);
 				}
 
 			//Element access :
 
 			reference	operator[](size_type pos)
-			{
-				pointer temp = this->start;
-				while (pos--)
-				{
-					temp++;
-				}
-				return *temp;
-			}
+			{ return (start[pos]); }
 
 			const_reference	operator[](size_type pos) const
-			{
-				pointer temp = this->start;
-				while (pos--)
-				{
-					temp++;
-				}
-				return *temp;
-			}
+			{ return (start[pos]); }
 
 			reference at( size_type pos )
 			{
@@ -314,8 +301,12 @@ namespace ft
 					allocator_type temp;
 					pointer newstart, new_end;
 					newstart = temp.allocate(n);
-					new_end = vcopy(temp, newstart, start, _end);
-					vclean(_alloc, start, _end);
+					// nothing to copy: an empty vector keeps _end on start
+					if (_size == 0)
+						new_end = newstart;
+					else
+						new_end = vcopy(temp, newstart, start, _end);
+					vclean(_alloc, start);
 					_capacity = n;
 					start = newstart;
 					_end = new_end;
@@ -331,22 +322,14 @@ namespace ft
 					if ( n > _capacity)
 						reserve( n );
 					while (_size < n)
-					{
-						_size++;
-						_end++;
-						_alloc.construct(_end, val);
-					}
+						push_back(val);
 				}
 				else if ( n == _size )
 					return ;
 				else if ( n < _size )
 				{
 					while ( _size > n )
-					{
-						_alloc.destroy(_end);
-						_end--;
-						_size--;
-					}
+						pop_back();
 				}
 			}
 
@@ -356,9 +339,7 @@ namespace ft
 			void	assign(InputIterator first, InputIterator last,
 					typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type* = nullptr)
 			{
-				for (; _size > 0; _size--)
-					_alloc.destroy(_end--);
-				_alloc.destroy(_end);
+				clear();
 				while (first != last)
 				{
 					push_back(*first);
@@ -369,18 +350,22 @@ namespace ft
 			void	assign( size_type n, const value_type& val )
 			{
 				sizecheck( n );
-				for (; _size > 0; _size--)
-					_alloc.destroy(_end--);
-				_alloc.destroy(_end);
+				clear();
 				while (n--)
 					push_back(val);
 			}
 
 			iterator insert( iterator position, const value_type& val )
 			{
-				size_type pos = &(*position) - start;
+				size_type pos = position - begin();
+				if (position == end())
+				{
+					push_back(val);
+					return (iterator(start + pos));
+				}
 				if (_size + 1 > _capacity )
 				{
+					size_type old_capacity = _capacity;
 					pointer newstart = _alloc.allocate((_capacity * 2 > 0 ? _capacity * 2 : 1));
 					_capacity = (_capacity * 2 > 0 ? _capacity * 2 : 1);
 					pointer newend = newstart;
@@ -401,7 +386,7 @@ namespace ft
 					for (size_type l = 0; l < size(); l++)
 						_alloc.destroy(start + l);
 					if (start)
-						_alloc.deallocate(start, capacity());
+						_alloc.deallocate(start, old_capacity);
 
 					newend--;
 					start = newstart;
@@ -437,8 +422,11 @@ namespace ft
 
 			void insert (iterator position, size_type n, const value_type& val)
 			{
+				if (n == 0)
+					return ;
 				if (_size + n > _capacity)
 				{
+					size_type old_capacity = _capacity;
 					while (_capacity < _size + n)
 						_capacity = (_capacity * 2 > 0 ? _capacity * 2 : 1);
 					pointer newstart = _alloc.allocate(_capacity);
@@ -464,7 +452,7 @@ namespace ft
 					for (size_type l = 0; l < size(); l++)
 						_alloc.destroy(start + l);
 					if (start)
-						_alloc.deallocate(start, capacity());
+						_alloc.deallocate(start, old_capacity);
 
 					newend--;
 					start = newstart;
@@ -473,28 +461,24 @@ namespace ft
 				}
 				else
 				{
-					_size += n;
-					pointer temp = start;
-					iterator it = begin();
-					while (it != position)
+					size_type pos = position - begin();
+					// shift the tail up by n: slots past the old end are raw memory
+					for (size_type i = _size; i > pos; i--)
 					{
-						it++;
-						temp++;
+						if (i - 1 + n >= _size)
+							_alloc.construct(start + i - 1 + n, start[i - 1]);
+						else
+							start[i - 1 + n] = start[i - 1];
 					}
-					ft::vector<value_type> t;
-					for (; it != end(); it++)
-						t.push_back(*it);	
-					for (size_type counter = n; counter; counter--)
+					for (size_type i = pos; i < pos + n; i++)
 					{
-						_alloc.destroy(temp);
-						_alloc.construct(temp++, val);
+						if (i >= _size)
+							_alloc.construct(start + i, val);
+						else
+							start[i] = val;
 					}
-					for (size_type i = 0; i < t.size(); i++)
-					{
-						_alloc.destroy(temp);
-						_alloc.construct(temp++, t[i]);
-					}
-					_end = temp - 1;
+					_size += n;
+					_end = start + _size - 1;
 				}
 				return ;
 			}
@@ -503,8 +487,11 @@ namespace ft
     		void insert (iterator position, InputIterator first, InputIterator last)
 			{
 				difference_type diff = last - first;
+				if (diff == 0)
+					return ;
 				if (_size + diff > _capacity)
 				{
+					size_type old_capacity = _capacity;
 					while (_capacity < _size + diff)
 						_capacity = (_capacity * 2 > 0 ? _capacity * 2 : 1);
 					pointer newstart = _alloc.allocate(_capacity);
@@ -530,7 +517,7 @@ namespace ft
 					for (size_type l = 0; l < size(); l++)
 						_alloc.destroy(start + l);
 					if (start)
-						_alloc.deallocate(start, capacity());
+						_alloc.deallocate(start, old_capacity);
 
 					newend--;
 					start = newstart;
@@ -569,57 +556,29 @@ namespace ft
 			}
 
 			iterator erase (iterator position)
-			{
-				ft::vector<value_type> t;
-				for (iterator it = position; &(*it) != nullptr && it != end();)
-				{
-					it++;
-					t.push_back(*it);
-				}
-				pointer temp = start;
-				while (temp != &(*position)) temp++;
-				pointer ret = temp;
-				for (pointer p = temp; p != _end; p++)
-					_alloc.destroy(p);
-				for (size_type i = 0; i < t.size(); i++)
-				{
-					_alloc.construct(temp, t[i]);
-					temp++;
-				}
-				_end--;
-				_size--;
-				return iterator(ret);
-			}
+			{ return (erase(position, position + 1)); }
 
 			iterator erase (iterator first, iterator last)
 			{
-				difference_type diff = last - first;
-				ft::vector<value_type> t;
-				for (iterator it = last; &(*it) != nullptr && it != end();)
-				{
-					it++;
-					t.push_back(*it);
-				}
-				pointer temp = start;
-				while (temp != &(*first)) temp++;
-				pointer ret = temp;
-				for (pointer p = &(*first); p != &(*last); p++)
-					_alloc.destroy(p);
-				for (size_type i = 0; i < t.size(); i++)
-				{
-					_alloc.construct(temp, t[i]);
-					temp++;
-				}
-				_end -= diff;
+				size_type pos = first - begin();
+				size_type diff = last - first;
+				if (diff == 0)
+					return (first);
+				// shift the tail down over the erased range, then drop the leftovers
+				for (size_type i = pos; i + diff < _size; i++)
+					start[i] = start[i + diff];
+				for (size_type i = _size - diff; i < _size; i++)
+					_alloc.destroy(start + i);
 				_size -= diff;
-				return (iterator(ret));
+				_end = (_size == 0) ? start : start + _size - 1;
+				return (iterator(start + pos));
 			}
 
 			void	clear()
 			{ 
 				for (; _size > 0; _size--)
-					_alloc.destroy(_end--);
-				_alloc.destroy(_end);
+					_alloc.destroy(start + _size - 1);
+				_end = start;
 			}
 
 			void	swap( vector& x)
@@ -652,21 +611,12 @@ namespace ft
 
 			void	push_back( const value_type& val )
 			{
+				// reserve() also frees the empty block a zero sized
+				// constructor may have allocated
 				if ( _size >= _capacity )
-				{
-					if (_capacity == 0)
-					{
-						start = _alloc.allocate(1);
-						_end = start;
-						_capacity = 1;
-						_size = 1;
-						_alloc.construct(_end, val);
-						return ;
-					}
-					else
-						reserve( _capacity * 2 );
-				}
-				_end++;
+					reserve( _capacity == 0 ? 1 : _capacity * 2 );
+				if (_size != 0)
+					_end++;
 				_size++;
 				_alloc.construct(_end, val);
 			}
@@ -676,8 +626,9 @@ namespace ft
 				if (empty() == false)
 				{
 					_alloc.destroy(_end);
-					_end--;
 					_size--;
+					if (_size != 0)
+						_end--;
 				}
 			}
 
@@ -690,6 +641,7 @@ namespace ft
 		private :
 			allocator_type _alloc;
 			pointer	start;
+			// the last element, or start while empty: _size tells them apart
 			pointer _end;
 			size_type _size;
 			size_type _capacity;
@@ -721,14 +673,12 @@ namespace ft
 				}
 			}
 
-			void	vclean(allocator_type v, pointer start, pointer _end)
+			void	vclean(allocator_type v, pointer start)
 			{
-				while (_end != start)
-				{
-					v.destroy(_end);
-					_end--;
-				}
-				v.deallocate(start, _capacity);
+				for (size_type n = _size; n > 0; n--)
+					v.destroy(start + n - 1);
+				if (start)
+					v.deallocate(start, _capacity);
 			}
 
 